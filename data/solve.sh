@@ -0,0 +1,14 @@
+#!/bin/sh
+
+export LD_LIBRARY_PATH=/usr/local/lib/:$LD_LIBRARY_PATH
+
+CURR_DIR=$(dirname $0)
+
+# Generate the solved tables for all the boards small
+# enough to be solved exactly.
+mkdir -p data/tables
+
+for dims in "2 2" "2 3" "3 2" "3 3"; do
+  set -- $dims
+  ./bin/2048-solver $1 $2 data/tables/$1x$2.tbl
+done
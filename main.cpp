@@ -1,51 +1,105 @@
-
-/**
- * @brief - A clone of the 2048 board game. See more info here:
- *          https://github.com/gabrielecirulli/2048
- */
-
-# include <core_utils/log/StdLogger.hh>
-# include <core_utils/log/PrefixedLogger.hh>
-# include <core_utils/log/Locator.hh>
-# include <core_utils/CoreException.hh>
-# include "AppDesc.hh"
-# include "TopViewFrame.hh"
-# include "App.hh"
-
-int
-main(int /*argc*/, char** /*argv*/) {
-  // Create the logger.
-  utils::log::StdLogger raw;
-  raw.setLevel(utils::log::Severity::DEBUG);
-  utils::log::PrefixedLogger logger("pge", "main");
-  utils::log::Locator::provide(&raw);
-
-  try {
-    logger.notice("Starting application");
-
-    pge::Viewport tViewport = pge::Viewport(olc::vf2d(-1.5f, -1.5f), olc::vf2d(10.0f, 10.0f));
-    pge::Viewport pViewport = pge::Viewport(olc::vf2d(0.0f, 0.0f), olc::vf2d(768.0f, 768.0f));
-
-    pge::CoordinateFrameShPtr cf = std::make_shared<pge::TopViewFrame>(
-      tViewport,
-      pViewport,
-      olc::vi2d(64, 64)
-    );
-    pge::AppDesc ad = pge::newDesc(olc::vi2d(768, 768), cf, "2048");
-    ad.fixedFrame = true;
-    pge::App demo(ad);
-
-    demo.Start();
-  }
-  catch (const utils::CoreException& e) {
-    logger.error("Caught internal exception while setting up application", e.what());
-  }
-  catch (const std::exception& e) {
-    logger.error("Caught internal exception while setting up application", e.what());
-  }
-  catch (...) {
-    logger.error("Unexpected error while setting up application");
-  }
-
-  return EXIT_SUCCESS;
-}
+
+/**
+ * @brief - A clone of the 2048 board game. See more info here:
+ *          https://github.com/gabrielecirulli/2048
+ */
+
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "AppDesc.hh"
+# include "TopViewFrame.hh"
+# include "App.hh"
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::DEBUG);
+  utils::log::PrefixedLogger logger("pge", "main");
+  utils::log::Locator::provide(&raw);
+
+  try {
+    logger.notice("Starting application");
+
+    pge::Viewport tViewport = pge::Viewport(olc::vf2d(-1.5f, -1.5f), olc::vf2d(10.0f, 10.0f));
+    pge::Viewport pViewport = pge::Viewport(olc::vf2d(0.0f, 0.0f), olc::vf2d(768.0f, 768.0f));
+
+    pge::CoordinateFrameShPtr cf = std::make_shared<pge::TopViewFrame>(
+      tViewport,
+      pViewport,
+      olc::vi2d(64, 64)
+    );
+    pge::AppDesc ad = pge::newDesc(olc::vi2d(768, 768), cf, "2048");
+    ad.fixedFrame = true;
+
+    // Record a trace of the session if requested: it is
+    // saved when the application exits. Huge boards can
+    // also be enabled: the frame can then be moved so as
+    // to explore the board.
+    bool huge = false;
+    for (int id = 1 ; id < argc ; ++id) {
+      std::string arg(argv[id]);
+
+      if (arg == "--huge") {
+        huge = true;
+        ad.fixedFrame = false;
+        continue;
+      }
+
+      // Inputs can be recorded or replayed, with a custom
+      // seed for the random number generator.
+      if (arg == "--record" && id + 1 < argc) {
+        ad.recordFile = argv[++id];
+        continue;
+      }
+      if (arg == "--replay" && id + 1 < argc) {
+        ad.replayFile = argv[++id];
+        continue;
+      }
+      if (arg == "--seed" && id + 1 < argc) {
+        ad.seed = static_cast<unsigned>(std::stoul(argv[++id]));
+        continue;
+      }
+
+      // Frames can be rendered offscreen, typically along
+      // with a replay, for a limited number of frames.
+      if (arg == "--headless") {
+        ad.headless = true;
+        continue;
+      }
+      if (arg == "--frames" && id + 1 < argc) {
+        ad.frames = static_cast<unsigned>(std::stoul(argv[++id]));
+        continue;
+      }
+      if (arg == "--snapshot" && id + 1 < argc) {
+        ad.snapshotFile = argv[++id];
+        continue;
+      }
+
+      if (arg != "--trace") {
+        continue;
+      }
+
+      ad.trace = true;
+      if (id + 1 < argc && std::string(argv[id + 1]).rfind("--", 0) != 0) {
+        ad.traceFile = argv[++id];
+      }
+    }
+    pge::App demo(ad, huge);
+
+    demo.Start();
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while setting up application", e.what());
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while setting up application", e.what());
+  }
+  catch (...) {
+    logger.error("Unexpected error while setting up application");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+
+/**
+ * @brief - Offline exact solver for small 2048 boards: it
+ *          computes the optimal play for all the reachable
+ *          positions and saves them in a table which can be
+ *          loaded by the game to provide perfect hints.
+ *          Usage: `2048-solver width height output [target] [threads]`.
+ */
+
+# include <core_utils/log/StdLogger.hh>
+# include <core_utils/log/PrefixedLogger.hh>
+# include <core_utils/log/Locator.hh>
+# include <core_utils/CoreException.hh>
+# include "Solver.hh"
+
+int
+main(int argc, char** argv) {
+  // Create the logger.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("pge", "solver");
+  utils::log::Locator::provide(&raw);
+
+  if (argc < 4) {
+    logger.error("Usage: " + std::string(argv[0]) + " width height output [target] [threads]");
+    return EXIT_FAILURE;
+  }
+
+  try {
+    unsigned width = std::stoul(argv[1]);
+    unsigned height = std::stoul(argv[2]);
+    std::string output = argv[3];
+    unsigned target = (argc > 4 ? std::stoul(argv[4]) : 0u);
+    unsigned threads = (argc > 5 ? std::stoul(argv[5]) : 0u);
+
+    logger.notice("Solving " + std::to_string(width) + "x" + std::to_string(height) + " board");
+
+    two48::Solver solver(width, height, threads);
+    solver.solve(target);
+    solver.save(output);
+  }
+  catch (const utils::CoreException& e) {
+    logger.error("Caught internal exception while solving board", e.what());
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception& e) {
+    logger.error("Caught internal exception while solving board", e.what());
+    return EXIT_FAILURE;
+  }
+  catch (...) {
+    logger.error("Unexpected error while solving board");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
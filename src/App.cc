@@ -1,55 +1,119 @@
 
 # include "App.hh"
+# include <array>
 # include <maths_utils/ComparisonUtils.hh>
 
 /// @brief - The border to have between cells.
 # define CELL_BORDER 0.1f
 
+/// @brief - The number of tiles in the atlas: this handles
+/// all the values up to `2^31`.
+# define ATLAS_TILES_COUNT 31u
+
+/// @brief - The number of entries in the color tables of the
+/// tiles: one for each exponent of a 32-bit value.
+# define TILE_COLORS_COUNT 32u
+
+/// @brief - The number of entries of the color tables using
+/// the classic colors of the game (up to `2048`). Colors of
+/// larger tiles are generated.
+# define CLASSIC_TILES_COUNT 12u
+
+/// @brief - The duration in seconds of the slide of the tiles
+/// when a move is played.
+# define SLIDE_DURATION 0.1f
+
+/// @brief - The duration in seconds of the growth of spawned
+/// tiles and of the pulse of merged tiles after a slide.
+# define POP_DURATION 0.1f
+
+/// @brief - The maximum increase in size of a merged tile during
+/// its pulse, relative to the size of a tile.
+# define POP_SCALE 0.2f
+
+/// @brief - The size in pixels below which tiles are drawn as
+/// plain rectangles: their value would not be readable anyway.
+/// This also applies to the animations of the moves.
+# define LOD_TILE_SIZE 20.0f
+
 namespace {
 
-  olc::Pixel
-  backgroundFromNumber(unsigned number) noexcept {
-    if (number <= 2u) {
-      return olc::Pixel(238, 228, 218);
-    }
-    else if (number <= 4u) {
-      return olc::Pixel(236, 224, 200);
-    }
-    else if (number <= 8u) {
-      return olc::Pixel(238, 177, 123);
-    }
-    else if (number <= 16u) {
-      return olc::Pixel(242, 150, 105);
-    }
-    else if (number <= 32u) {
-      return olc::Pixel(240, 125, 98);
-    }
-    else if (number <= 64u) {
-      return olc::Pixel(243, 95, 65);
-    }
-    else if (number <= 128u) {
-      return olc::Pixel(233, 206, 119);
-    }
-    else if (number <= 256u) {
-      return olc::Pixel(236, 203, 103);
-    }
-    else if (number <= 512u) {
-      return olc::Pixel(236, 200, 89);
-    }
-    else if (number <= 1024u) {
-      return olc::Pixel(231, 194, 87);
-    }
-    else if (number <= 2048u) {
-      return olc::Pixel(232, 189, 77);
+  /// @brief - The colors of the tiles indexed by their exponent.
+  using ColorTable = std::array<uint32_t, TILE_COLORS_COUNT>;
+
+  constexpr
+  ColorTable
+  generateBackgrounds() noexcept {
+    // The classic colors of the tiles up to `2048`: the
+    // first entry does not correspond to a tile.
+    ColorTable t{
+      pge::pack(238, 228, 218),
+      pge::pack(238, 228, 218),
+      pge::pack(236, 224, 200),
+      pge::pack(238, 177, 123),
+      pge::pack(242, 150, 105),
+      pge::pack(240, 125, 98),
+      pge::pack(243, 95, 65),
+      pge::pack(233, 206, 119),
+      pge::pack(236, 203, 103),
+      pge::pack(236, 200, 89),
+      pge::pack(231, 194, 87),
+      pge::pack(232, 189, 77)
+    };
+
+    // Larger tiles follow a gradient in `HSL` space from a
+    // light purple to a dark teal: the lightness alternates
+    // between consecutive tiles so that they can be easily
+    // distinguished.
+    uint32_t low = pge::pack(198, 150, 115);
+    uint32_t high = pge::pack(99, 150, 75);
+
+    for (unsigned e = CLASSIC_TILES_COUNT ; e < TILE_COLORS_COUNT ; ++e) {
+      float ratio = (e - CLASSIC_TILES_COUNT) / (TILE_COLORS_COUNT - CLASSIC_TILES_COUNT - 1.0f);
+      uint32_t hsl = pge::colorGradient(low, high, ratio, pge::alpha::Opaque);
+
+      if (e % 2u != 0u) {
+        hsl -= (20u << 16u);
+      }
+
+      t[e] = pge::HSLToRGB(hsl);
     }
-    else {
-      return olc::Pixel(44, 44, 44);
+
+    return t;
+  }
+
+  constexpr
+  ColorTable
+  generateTexts() noexcept {
+    // Only the lightest tiles use a dark text.
+    ColorTable t{};
+    for (unsigned e = 0u ; e < TILE_COLORS_COUNT ; ++e) {
+      t[e] = (e < 2u ? pge::pack(101, 95, 83) : pge::pack(255, 255, 255));
     }
+
+    return t;
+  }
+
+  /// @brief - The colors of the background and of the text of
+  /// the tiles, generated at compile time.
+  constexpr ColorTable BACKGROUNDS = generateBackgrounds();
+  constexpr ColorTable TEXTS = generateTexts();
+
+  inline
+  unsigned
+  exponentOf(unsigned number) noexcept {
+    // Tiles are powers of two.
+    return (number == 0u ? 0u : static_cast<unsigned>(__builtin_ctz(number)));
+  }
+
+  olc::Pixel
+  backgroundFromNumber(unsigned number) noexcept {
+    return olc::Pixel(BACKGROUNDS[exponentOf(number)]);
   }
 
   olc::Pixel
   colorFromNumber(unsigned number) noexcept {
-    return (number < 4u ? olc::Pixel(101, 95, 83) : olc::WHITE);
+    return olc::Pixel(TEXTS[exponentOf(number)]);
   }
 
   olc::vf2d
@@ -57,28 +121,29 @@ namespace {
     return olc::vf2d(4.0f - w / 2.0f + x, 4.0f - h / 2.0f + y);
   }
 
-  olc::vf2d
-  coordsToCell(float x, float y, unsigned w, unsigned h) noexcept{
-    return olc::vf2d(
-      std::floor(x - 3.5f + w / 2.0f),
-      std::floor(y - 3.5f + h / 2.0f)
-    );
-  }
-
 }
 
 namespace pge {
 
-  App::App(const AppDesc& desc):
+  App::App(const AppDesc& desc, bool huge):
     PGEApp(desc),
 
+    m_huge(huge),
+
     m_game(nullptr),
     m_state(nullptr),
     m_menus(),
 
     m_packs(std::make_shared<TexturePack>()),
+    m_atlas(
+      std::make_shared<TileAtlas>(ATLAS_TILES_COUNT, backgroundFromNumber, colorFromNumber)
+    ),
+
+    m_rendered(Rendered{0u, Screen::Home, olc::vi2d(-1, -1), olc::vi2d(-1, -1)}),
+
+    m_layout(),
 
-    m_directionalState(Direction::Count, false)
+    m_animation(Animation{false, 0.0f, two48::Trace(), std::vector<Effect>()})
   {}
 
   bool
@@ -88,13 +153,44 @@ namespace pge {
       return false;
     }
 
+    // Gather the packs loaded since the last frame in the
+    // atlas: their sprites are now drawn from other textures.
+    if (m_packs != nullptr && m_packs->update()) {
+      invalidate();
+    }
+
+    // Rebuild the atlas once the zoom settles: the tiles
+    // were drawn directly until then.
+    if (m_atlas != nullptr && m_atlas->settle(this, fElapsed)) {
+      invalidate(Layer::DrawDecal);
+    }
+
+    // Advance the animation of the last move: the board
+    // is rendered at each frame until it completes.
+    if (m_animation.active) {
+      m_animation.elapsed += fElapsed;
+      m_animation.active = (m_animation.elapsed < SLIDE_DURATION + POP_DURATION);
+      invalidate(Layer::DrawDecal);
+    }
+
     if (!m_game->step(fElapsed)) {
       m_state->setScreen(pge::Screen::GameOver);
     }
 
+    detectChanges();
+
     return m_game->terminated();
   }
 
+  bool
+  App::busy() const noexcept {
+    return
+      m_animation.active ||
+      (m_atlas != nullptr && m_atlas->pending()) ||
+      (m_game != nullptr && m_game->busy())
+    ;
+  }
+
   void
   App::onInputs(const controls::State& c,
                 const CoordinateFrame& cf)
@@ -131,22 +227,55 @@ namespace pge {
       m_game->performAction(tp.x + it.x, tp.y + it.y);
     }
 
-    if (!c.keys[controls::keys::Right] && m_directionalState[Direction::Right]) {
-      m_game->move(1, 0);
+    // Moves are triggered as soon as a directional key is
+    // pressed: all the presses received since the last frame
+    // are applied in order.
+    for (unsigned id = 0u ; id < c.events.size() ; ++id) {
+      const controls::KeyEvent& e = c.events[id];
+      if (!e.pressed) {
+        continue;
+      }
+
+      switch (e.key) {
+        case controls::keys::Right:
+          m_game->move(1, 0);
+          break;
+        case controls::keys::Up:
+          m_game->move(0, 1);
+          break;
+        case controls::keys::Left:
+          m_game->move(-1, 0);
+          break;
+        case controls::keys::Down:
+          m_game->move(0, -1);
+          break;
+        default:
+          continue;
+      }
+
+      // Record the delay between the key press and the
+      // update of the board.
+      profiling::Tracer::record("input to move", "inputs", e.time, utils::now());
     }
-    if (!c.keys[controls::keys::Up] && m_directionalState[Direction::Up]) {
-      m_game->move(0, 1);
+
+    // The overlay only needs to be rendered again when the
+    // mouse moves to another cell.
+    olc::vi2d mouse(c.mPosX, c.mPosY);
+
+    olc::vi2d cell(-1, -1);
+    if (!hoveredCell(cf, mouse, cell)) {
+      cell = olc::vi2d(-1, -1);
     }
-    if (!c.keys[controls::keys::Left] && m_directionalState[Direction::Left]) {
-      m_game->move(-1, 0);
+    if (cell != m_rendered.hovered) {
+      m_rendered.hovered = cell;
+      invalidate(Layer::DrawDecal);
     }
-    if (!c.keys[controls::keys::Down] && m_directionalState[Direction::Down]) {
-      m_game->move(0, -1);
+
+    // The debug layer displays the position of the mouse.
+    if (mouse != m_rendered.mouse) {
+      m_rendered.mouse = mouse;
+      invalidate(Layer::Debug);
     }
-    m_directionalState[Direction::Right] = c.keys[controls::keys::Right];
-    m_directionalState[Direction::Up] = c.keys[controls::keys::Up];
-    m_directionalState[Direction::Left] = c.keys[controls::keys::Left];
-    m_directionalState[Direction::Down] = c.keys[controls::keys::Down];
 
     if (c.keys[controls::keys::N] || c.keys[controls::keys::R]) {
       if (m_state->getScreen() == Screen::Game) {
@@ -163,7 +292,8 @@ namespace pge {
   void
   App::loadData() {
     // Create the game and its state.
-    m_game = std::make_shared<Game>();
+    m_game = std::make_shared<Game>(m_huge);
+    m_game->setDeterministic(deterministic());
   }
 
   void
@@ -201,6 +331,9 @@ namespace pge {
     if (m_packs != nullptr) {
       m_packs.reset();
     }
+    if (m_atlas != nullptr) {
+      m_atlas.reset();
+    }
   }
 
   void
@@ -220,22 +353,11 @@ namespace pge {
       return;
     }
 
-    const two48::Board& b = m_game->board();
-
-    SpriteDesc sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    sd.radius = std::max(b.w(), b.h()) + CELL_BORDER;
-
-    sd.x = 3.5f;
-    sd.y = 3.5f;
-
-    sd.sprite.tint = olc::Pixel(184, 171, 158);
-
     // The surrounding layer.
-    drawRect(sd, res.cf);
+    updateLayout(res.cf);
+    FillRectDecal(m_layout.boardPos, m_layout.boardSize, olc::Pixel(184, 171, 158));
 
     drawBoard(res);
-    drawNumbers(res);
     drawOverlays(res);
 
     SetPixelMode(olc::Pixel::NORMAL);
@@ -272,9 +394,13 @@ namespace pge {
       return;
     }
 
-    // Render the game menus.
+    // Render the game menus: all the backgrounds come first
+    // so that the renderer can batch them in a single draw.
     for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
-      m_menus[id]->render(this);
+      m_menus[id]->renderBackground(this);
+    }
+    for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
+      m_menus[id]->renderContent(this);
     }
 
     SetPixelMode(olc::Pixel::NORMAL);
@@ -294,8 +420,9 @@ namespace pge {
       return;
     }
 
-    // Draw cursor's position.
-    olc::vi2d mp = GetMousePos();
+    // Draw cursor's position: it comes from the controls
+    // so that it follows the replayed inputs.
+    olc::vi2d mp = m_rendered.mouse;
     olc::vf2d it;
     olc::vi2d mtp = res.cf.pixelCoordsToTiles(mp, &it);
 
@@ -305,6 +432,8 @@ namespace pge {
     DrawString(olc::vi2d(0, h / 2 + 1 * dOffset), "World cell coords : " + toString(mtp), olc::CYAN);
     DrawString(olc::vi2d(0, h / 2 + 2 * dOffset), "Intra cell        : " + toString(it), olc::CYAN);
 
+    drawTimings(olc::vi2d(0, h / 2 + 4 * dOffset));
+
     SetPixelMode(olc::Pixel::NORMAL);
   }
 
@@ -313,85 +442,307 @@ namespace pge {
     // The colors of the cells.
     olc::Pixel empty(203, 191, 178);
 
-    SpriteDesc sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    // Assume that the tile size is a square and scale
-    // the tiles so that they occupy one tile.
-    sd.radius = 1.0f - CELL_BORDER;
+    // Make sure the tiles are rendered with the current
+    // size of the cells.
+    updateLayout(res.cf);
+    const olc::vf2d& size = m_layout.size;
 
     const two48::Board& b = m_game->board();
+    CellsRange cells = visibleCells();
+
+    // Small tiles are drawn as plain rectangles over a single
+    // rectangle for all the visible cells: the gaps between
+    // the cells would hardly be visible anyway.
+    if (lowDetails()) {
+      if (cells.xMin >= cells.xMax || cells.yMin >= cells.yMax) {
+        return;
+      }
+
+      olc::vf2d from = cellPos(cells.xMin, cells.yMin);
+      olc::vf2d to = cellPos(cells.xMax - 1u, cells.yMax - 1u) + size;
+      FillRectDecal(from, to - from, empty);
+
+      for (unsigned y = cells.yMin ; y < cells.yMax ; ++y) {
+        for (unsigned x = cells.xMin ; x < cells.xMax ; ++x) {
+          unsigned val = b.at(x, y);
+          if (val != 0u) {
+            FillRectDecal(cellPos(x, y), size, backgroundFromNumber(val));
+          }
+        }
+      }
+
+      return;
+    }
 
-    // Draw the board.
-    for (unsigned y = 0u ; y < b.h() ; ++y) {
-      for (unsigned x = 0u ; x < b.w() ; ++x) {
-        olc::vf2d p = cellToCoords(x, y, b.w(), b.h());
-        sd.x = p.x;
-        sd.y = p.y;
+    m_atlas->update(this, static_cast<unsigned>(std::round(size.x)));
 
-        sd.sprite.tint = b.empty(x, y) ? empty : backgroundFromNumber(b.at(x, y));
+    if (m_animation.active) {
+      drawAnimation(b, empty, cells);
+      return;
+    }
 
-        drawRect(sd, res.cf);
+    // Draw the empty cells first and then the tiles: as
+    // they don't overlap, this allows the renderer to
+    // submit each group in a single batch.
+    for (unsigned y = cells.yMin ; y < cells.yMax ; ++y) {
+      for (unsigned x = cells.xMin ; x < cells.xMax ; ++x) {
+        if (b.empty(x, y)) {
+          FillRectDecal(cellPos(x, y), size, empty);
+        }
+      }
+    }
+
+    for (unsigned y = cells.yMin ; y < cells.yMax ; ++y) {
+      for (unsigned x = cells.xMin ; x < cells.xMax ; ++x) {
+        if (b.empty(x, y)) {
+          continue;
+        }
+
+        drawTile(b.at(x, y), cellPos(x, y), size);
       }
     }
   }
 
   void
-  App::drawNumbers(const RenderDesc& res) noexcept {
-    const two48::Board& b = m_game->board();
+  App::drawAnimation(const two48::Board& b,
+                     const olc::Pixel& empty,
+                     const CellsRange& cells) noexcept
+  {
+    const olc::vf2d& size = m_layout.size;
+    unsigned w = b.w();
+
+    // Tiles travel over the other cells so all of them
+    // are drawn as empty.
+    for (unsigned y = cells.yMin ; y < cells.yMax ; ++y) {
+      for (unsigned x = cells.xMin ; x < cells.xMax ; ++x) {
+        FillRectDecal(cellPos(x, y), size, empty);
+      }
+    }
 
-    // The scale for the numbers.
-    olc::vf2d scale(2.0f, 2.0f);
+    // During the slide, the tiles are drawn with their
+    // value before the move: the spawned tile and the
+    // merged tiles are not visible yet.
+    if (m_animation.elapsed < SLIDE_DURATION) {
+      // Decelerate when reaching the final cell.
+      float p = 1.0f - m_animation.elapsed / SLIDE_DURATION;
+      p = 1.0f - p * p * p;
 
-    // Draw the numbers.
-    for (unsigned y = 0u ; y < b.h() ; ++y) {
-      for (unsigned x = 0u ; x < b.w() ; ++x) {
-        if (b.empty(x, y)) {
+      for (unsigned id = 0u ; id < m_animation.slides.size() ; ++id) {
+        const two48::Slide& s = m_animation.slides[id];
+
+        // Tiles slide along a row or a column: they are only
+        // visible if this segment crosses the visible cells.
+        unsigned fx = s.from % w;
+        unsigned fy = s.from / w;
+        unsigned tx = s.to % w;
+        unsigned ty = s.to / w;
+
+        bool visibleX = std::max(fx, tx) >= cells.xMin && std::min(fx, tx) < cells.xMax;
+        bool visibleY = std::max(fy, ty) >= cells.yMin && std::min(fy, ty) < cells.yMax;
+        if (!visibleX || !visibleY) {
           continue;
         }
 
-        unsigned val = b.at(x, y);
-        std::string str = std::to_string(val);
+        olc::vf2d from = cellPos(fx, fy);
+        drawTile(s.value, from + (cellPos(tx, ty) - from) * p, size);
+      }
 
-        olc::vf2d p = cellToCoords(x + 0.5f, y + 0.5f, b.w(), b.h());
+      return;
+    }
+
+    // Then the final board is drawn with a pulse of the
+    // merged tiles and the growth of the spawned one.
+    float p = std::min((m_animation.elapsed - SLIDE_DURATION) / POP_DURATION, 1.0f);
 
-        olc::vf2d pNum = res.cf.tileCoordsToPixels(p.x, p.y, pge::RelativePosition::Center, 1.0f);
+    for (unsigned y = cells.yMin ; y < cells.yMax ; ++y) {
+      for (unsigned x = cells.xMin ; x < cells.xMax ; ++x) {
+        unsigned val = b.at(x, y);
+        if (val == 0u) {
+          continue;
+        }
 
-        // More or less center the text in the cell.
-        olc::vi2d sz = GetTextSize(str);
-        pNum.x -= sz.x;
-        pNum.y -= sz.y;
+        float scale = 1.0f;
+        switch (m_animation.effects[y * w + x]) {
+          case Effect::Merged:
+            scale += POP_SCALE * 4.0f * p * (1.0f - p);
+            break;
+          case Effect::Spawned:
+            scale = p;
+            break;
+          case Effect::None:
+          default:
+            break;
+        }
 
-        DrawStringDecal(pNum, str, colorFromNumber(val), scale);
+        drawTile(val, cellPos(x, y) + size * (1.0f - scale) / 2.0f, size * scale);
       }
     }
   }
 
   void
-  App::drawOverlays(const RenderDesc& res) noexcept {
-    SpriteDesc sd = {};
-    sd.loc = pge::RelativePosition::Center;
-    sd.radius = 1.0f - CELL_BORDER;
+  App::drawTile(unsigned value, const olc::vf2d& pos, const olc::vf2d& size) noexcept {
+    if (m_atlas->draw(this, value, pos, size)) {
+      return;
+    }
 
-    const two48::Board& b = m_game->board();
+    // Tiles which are not handled by the atlas are rendered
+    // on the fly: this should hardly ever happen.
+    FillRectDecal(pos, size, backgroundFromNumber(value));
+
+    std::string str = std::to_string(value);
+    olc::vi2d sz = GetTextSize(str);
+    DrawStringDecal(pos + (size - olc::vf2d(sz.x, sz.y)) / 2.0f, str, colorFromNumber(value));
+  }
 
+  void
+  App::drawOverlays(const RenderDesc& res) noexcept {
     // Draw the overlay in case the mouse is over
     // a cell with a piece.
-    olc::vi2d mp = GetMousePos();
-    olc::vf2d it;
-    olc::vi2d mtp = res.cf.pixelCoordsToTiles(mp, &it);
+    olc::vi2d cp;
+    if (hoveredCell(res.cf, m_rendered.mouse, cp)) {
+      olc::vf2d pos = cellPos(cp.x, cp.y);
+      FillRectDecal(pos, m_layout.size, olc::Pixel(101, 95, 89, pge::alpha::AlmostTransparent));
+    }
+  }
+
+  bool
+  App::hoveredCell(const CoordinateFrame& cf, const olc::vi2d& mouse, olc::vi2d& cell) noexcept {
+    updateLayout(cf);
+
+    // The cells are laid out on a regular grid so we can
+    // directly compute the cell under the mouse.
+    olc::vf2d cp = (olc::vf2d(mouse.x, mouse.y) - m_layout.origin) / m_layout.pitch;
+
+    cell = olc::vi2d(static_cast<int>(std::floor(cp.x)), static_cast<int>(std::floor(cp.y)));
+
+    bool validX = (cell.x >= 0 && static_cast<unsigned>(cell.x) < m_layout.w);
+    bool validY = (cell.y >= 0 && static_cast<unsigned>(cell.y) < m_layout.h);
+
+    return validX && validY;
+  }
+
+  void
+  App::updateLayout(const CoordinateFrame& cf) noexcept {
+    const two48::Board& b = m_game->board();
+
+    // Nothing to do if neither the board nor the frame
+    // changed since the last computation.
+    if (m_layout.valid && m_layout.w == b.w() && m_layout.h == b.h() && m_layout.frame == cf.revision()) {
+      return;
+    }
+
+    m_layout.w = b.w();
+    m_layout.h = b.h();
+    m_layout.frame = cf.revision();
+    m_layout.valid = true;
+
+    // The area surrounding the board.
+    float radius = std::max(b.w(), b.h()) + CELL_BORDER;
+    m_layout.boardPos = cf.tileCoordsToPixels(3.5f, 3.5f, RelativePosition::Center, radius);
+    m_layout.boardSize = radius * cf.tileSize();
+
+    // The area of the first cell: each cell occupies a tile
+    // of the frame, centered on the position returned by
+    // `cellToCoords`.
+    olc::vf2d p = cellToCoords(0.0f, 0.0f, b.w(), b.h());
+    m_layout.origin = cf.tileCoordsToPixels(p.x, p.y, RelativePosition::Center, 1.0f);
+    m_layout.pitch = cf.tileSize();
+
+    // Assume that the tile size is a square and scale
+    // the tiles so that they occupy one tile.
+    radius = 1.0f - CELL_BORDER;
+    m_layout.size = radius * cf.tileSize();
+
+    // The other cells are offset from the first one by the
+    // size of a tile of the frame.
+    m_layout.first = cf.tileCoordsToPixels(p.x, p.y, RelativePosition::Center, radius);
+  }
+
+  olc::vf2d
+  App::cellPos(unsigned x, unsigned y) const noexcept {
+    return m_layout.first + m_layout.pitch * olc::vf2d(x, y);
+  }
+
+  App::CellsRange
+  App::visibleCells() const noexcept {
+    // Convert the corners of the screen to cells and keep
+    // the cells which are at least partially visible.
+    olc::vf2d tl = (olc::vf2d(0.0f, 0.0f) - m_layout.origin) / m_layout.pitch;
+    olc::vf2d br = (olc::vf2d(ScreenWidth(), ScreenHeight()) - m_layout.origin) / m_layout.pitch;
+
+    auto clamp = [](float v, unsigned max) {
+      return static_cast<unsigned>(std::min(std::max(v, 0.0f), static_cast<float>(max)));
+    };
+
+    return CellsRange{
+      clamp(std::floor(tl.x), m_layout.w),
+      clamp(std::ceil(br.x), m_layout.w),
+      clamp(std::floor(tl.y), m_layout.h),
+      clamp(std::ceil(br.y), m_layout.h)
+    };
+  }
 
-    // Convert raw cells to coordinates.
-    olc::vf2d cp = coordsToCell(mtp.x + it.x, mtp.y + it.y, b.w(), b.h());
+  bool
+  App::lowDetails() const noexcept {
+    return m_layout.size.x < LOD_TILE_SIZE;
+  }
+
+  void
+  App::detectChanges() noexcept {
+    // A change of screen affects all the layers.
+    if (m_state->getScreen() != m_rendered.screen) {
+      m_rendered.screen = m_state->getScreen();
+      invalidate();
+    }
+
+    // The screens of the state are rendered in several
+    // layers.
+    if (m_state->consumeChanges()) {
+      invalidate(Layer::Draw);
+      invalidate(Layer::UI);
+      invalidate(Layer::Debug);
+    }
+
+    // Make sure that all the menus are consumed.
+    bool menus = false;
+    for (unsigned id = 0u ; id < m_menus.size() ; ++id) {
+      menus = m_menus[id]->consumeChanges() || menus;
+    }
+    if (menus) {
+      invalidate(Layer::UI);
+    }
+
+    if (m_game->revision() != m_rendered.revision) {
+      m_rendered.revision = m_game->revision();
+      invalidate(Layer::DrawDecal);
+      startAnimation();
+    }
+  }
+
+  void
+  App::startAnimation() noexcept {
+    // Only moves are animated: the board is displayed
+    // right away after an undo or a reset.
+    const two48::Trace* trace = m_game->trace();
+    const two48::Board& b = m_game->board();
+
+    // Small tiles are not animated as the motion would not
+    // be visible anyway.
+    m_animation.active = (trace != nullptr && !trace->empty());
+    m_animation.active = m_animation.active && !(m_layout.valid && lowDetails());
+    if (!m_animation.active) {
+      return;
+    }
 
-    bool validX = (cp.x >= 0 && static_cast<unsigned>(cp.x) < b.w());
-    bool validY = (cp.y >= 0 && static_cast<unsigned>(cp.y) < b.h());
-    if (validX && validY) {
-      olc::vf2d p = cellToCoords(cp.x, cp.y, b.w(), b.h());
-      sd.x = p.x;
-      sd.y = p.y;
+    m_animation.elapsed = 0.0f;
+    m_animation.slides.assign(trace->begin(), trace->end());
 
-      sd.sprite.tint = olc::Pixel(101, 95, 89, pge::alpha::AlmostTransparent);
-      drawRect(sd, res.cf);
+    // Cells which are not reached by any tile hold the
+    // spawned tile if they are not empty.
+    m_animation.effects.assign(b.w() * b.h(), Effect::Spawned);
+    for (unsigned id = 0u ; id < m_animation.slides.size() ; ++id) {
+      const two48::Slide& s = m_animation.slides[id];
+      m_animation.effects[s.to] = (s.merged ? Effect::Merged : Effect::None);
     }
   }
 
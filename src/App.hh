@@ -4,6 +4,7 @@
 # include <vector>
 # include "PGEApp.hh"
 # include "TexturePack.hh"
+# include "TileAtlas.hh"
 # include "Menu.hh"
 # include "Game.hh"
 # include "GameState.hh"
@@ -18,8 +19,11 @@ namespace pge {
        * @param desc - contains all the needed information to
        *               create the canvas needed by the app and
        *               set up base properties.
+       * @param huge - whether boards up to `256x256` can be
+       *               played. The coordinate frame should not be
+       *               fixed so that the board can be explored.
        */
-      App(const AppDesc& desc);
+      App(const AppDesc& desc, bool huge = false);
 
       /**
        * @brief - Desctruction of the object.
@@ -55,6 +59,9 @@ namespace pge {
       void
       drawDebug(const RenderDesc& res) override;
 
+      bool
+      busy() const noexcept override;
+
       bool
       onFrame(float fElapsed) override;
 
@@ -92,6 +99,16 @@ namespace pge {
         Vertical
       };
 
+      /// @brief - A range of cells of the board: the upper bounds
+      /// are excluded.
+      struct CellsRange {
+        unsigned xMin;
+        unsigned xMax;
+
+        unsigned yMin;
+        unsigned yMax;
+      };
+
       /**
        * @brief - Used to draw the tile referenced by the input
        *          struct to the screen using the corresponding
@@ -115,27 +132,191 @@ namespace pge {
       drawRect(const SpriteDesc& t,
                const CoordinateFrame& cf);
 
+      /**
+       * @brief - Draw the cells of the board: empty cells are drawn
+       *          as plain rectangles while tiles are drawn from the
+       *          tile atlas. Only the visible cells are drawn and
+       *          when the tiles are too small for their value to
+       *          be readable they are drawn as plain rectangles.
+       * @param res - the description of the rendering.
+       */
       void
       drawBoard(const RenderDesc& res) noexcept;
 
+      /**
+       * @brief - Draw the tiles of the board while the last move is
+       *          animated: tiles first slide from their initial cell
+       *          to their final one, then merged tiles pulse while
+       *          the spawned tile grows.
+       * @param b - the board to draw.
+       * @param empty - the color of the empty cells.
+       * @param cells - the range of visible cells.
+       */
+      void
+      drawAnimation(const two48::Board& b,
+                    const olc::Pixel& empty,
+                    const CellsRange& cells) noexcept;
+
+      /**
+       * @brief - Draw a single tile, from the atlas if possible.
+       * @param value - the value of the tile.
+       * @param pos - the top left corner of the tile in pixels.
+       * @param size - the size of the tile in pixels.
+       */
       void
-      drawNumbers(const RenderDesc& res) noexcept;
+      drawTile(unsigned value, const olc::vf2d& pos, const olc::vf2d& size) noexcept;
 
       void
       drawOverlays(const RenderDesc& res) noexcept;
 
+      /**
+       * @brief - Compute the cell of the board under the mouse.
+       * @param cf - the coordinate frame to use to convert the
+       *             position of the mouse to cells.
+       * @param mouse - the position of the mouse in pixels.
+       * @param cell - output argument receiving the coordinates
+       *               of the cell.
+       * @return - `false` if the mouse is not over the board.
+       */
+      bool
+      hoveredCell(const CoordinateFrame& cf, const olc::vi2d& mouse, olc::vi2d& cell) noexcept;
+
+      /**
+       * @brief - The top left corner in pixels of a tile.
+       * @param x - the column of the cell.
+       * @param y - the row of the cell.
+       * @return - the position of the tile.
+       */
+      olc::vf2d
+      cellPos(unsigned x, unsigned y) const noexcept;
+
+      /**
+       * @brief - Compute the range of cells of the board which are
+       *          visible on screen from the layout.
+       * @return - the range of visible cells.
+       */
+      CellsRange
+      visibleCells() const noexcept;
+
+      /**
+       * @brief - Whether the tiles are too small for their values
+       *          to be readable, in which case they are rendered as
+       *          plain rectangles.
+       * @return - `true` if the simplified tiles should be used.
+       */
+      bool
+      lowDetails() const noexcept;
+
+      /**
+       * @brief - Compute the position in pixels of the cells of
+       *          the board if the dimensions of the board or the
+       *          coordinate frame changed since the last call.
+       * @param cf - the coordinate frame to use to convert the
+       *             cells to pixels.
+       */
+      void
+      updateLayout(const CoordinateFrame& cf) noexcept;
+
+      /**
+       * @brief - Compare the data displayed in the last rendering
+       *          with the current state of the game and invalidate
+       *          the layers which need to be rendered again.
+       */
+      void
+      detectChanges() noexcept;
+
+      /**
+       * @brief - Start the animation of the last move of the game,
+       *          if the board results from a move.
+       */
+      void
+      startAnimation() noexcept;
+
     private:
 
-      /// @brief - Convenience enumeration to refer to the directions.
-      enum Direction {
-        Right,
-        Up,
-        Left,
-        Down,
+      /// @brief - The data used by the last rendering of the layers,
+      /// which allows to detect when they need to be rendered again.
+      struct Rendered {
+        // The revision of the board.
+        unsigned revision;
 
-        Count
+        // The screen of the game.
+        Screen screen;
+
+        // The position of the mouse.
+        olc::vi2d mouse;
+
+        // The cell of the board under the mouse, or `-1` if the
+        // mouse is not over the board.
+        olc::vi2d hovered;
+      };
+
+      /// @brief - The position in pixels of the elements of the
+      /// board. It only changes with the dimensions of the board or
+      /// the coordinate frame so it is cached between frames.
+      struct Layout {
+        // Whether the layout was computed.
+        bool valid;
+
+        // The dimensions of the board.
+        unsigned w;
+        unsigned h;
+
+        // The revision of the coordinate frame.
+        unsigned frame;
+
+        // The top left corner and the size in pixels of the area
+        // surrounding the board.
+        olc::vf2d boardPos;
+        olc::vf2d boardSize;
+
+        // The top left corner in pixels of the area occupied by
+        // the first cell (including its border) and the size of
+        // this area: this allows to find the cell at a position.
+        olc::vf2d origin;
+        olc::vf2d pitch;
+
+        // The size in pixels of a tile.
+        olc::vf2d size;
+
+        // The top left corner in pixels of the first tile: other
+        // tiles are offset by the pitch. The position of all the
+        // cells is not stored as there might be a lot of them.
+        olc::vf2d first;
       };
 
+      /// @brief - The effect applied to a tile once all the tiles
+      /// reached their final cell.
+      enum class Effect: uint8_t {
+        None,
+        Merged,
+        Spawned
+      };
+
+      /// @brief - The animation of the last move. Its buffers keep
+      /// their capacity from one move to the next so that nothing
+      /// is allocated while animating.
+      struct Animation {
+        // Whether the animation is running.
+        bool active;
+
+        // The time elapsed since the beginning of the animation in
+        // seconds.
+        float elapsed;
+
+        // The motion of the tiles during the move.
+        two48::Trace slides;
+
+        // The effect applied to each cell of the board after the
+        // tiles slid, stored row after row.
+        std::vector<Effect> effects;
+      };
+
+      /**
+       * @brief - Whether boards larger than usual can be played.
+       */
+      bool m_huge;
+
       /**
        * @brief - The game managed by this application.
        */
@@ -161,9 +342,24 @@ namespace pge {
       TexturePackShPtr m_packs;
 
       /**
-       * @brief - The state of each of the directional keys.
+       * @brief - The pre-rendered visuals of the tiles.
+       */
+      TileAtlasShPtr m_atlas;
+
+      /**
+       * @brief - The data displayed by the last rendering.
+       */
+      Rendered m_rendered;
+
+      /**
+       * @brief - The position in pixels of the cells of the board.
+       */
+      Layout m_layout;
+
+      /**
+       * @brief - The animation of the last move.
        */
-      std::vector<bool> m_directionalState;
+      Animation m_animation;
   };
 
 }
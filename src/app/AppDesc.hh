@@ -30,6 +30,49 @@ namespace pge {
     // Whether or not the coordinate frame is fixed (meaning
     // that panning and zooming is disabled) or not.
     bool fixedFrame;
+
+    // The maximum number of frames rendered per second while
+    // the content of the app changes. A value of `0` means no
+    // limit.
+    float frameRate;
+
+    // The maximum duration in seconds to wait for an event when
+    // the content of the app does not change. A value of `0`
+    // means that frames are rendered continuously.
+    float idleTimeout;
+
+    // Whether a trace of the execution should be recorded from
+    // the start of the app.
+    bool trace;
+
+    // The file where the trace is saved, either when the `T` key
+    // is pressed while recording or when the app exits.
+    std::string traceFile;
+
+    // The seed of the random number generator.
+    unsigned seed;
+
+    // The file where the inputs of each frame are recorded. No
+    // inputs are recorded if it is empty.
+    std::string recordFile;
+
+    // The file from which the inputs are replayed instead of being
+    // read from the devices: the seed saved in the recording is
+    // used. The devices are used if it is empty.
+    std::string replayFile;
+
+    // Whether the frames are rendered in memory rather than in a
+    // window: no display server is needed. Frames are rendered as
+    // fast as possible.
+    bool headless;
+
+    // The number of frames after which the app exits. A value of
+    // `0` means no limit.
+    unsigned frames;
+
+    // The file where the last frame is saved as a PNG image when
+    // the app exits. Only used when the app is headless.
+    std::string snapshotFile;
   };
 
   /**
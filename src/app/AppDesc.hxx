@@ -22,6 +22,20 @@ namespace pge {
 
     ad.fixedFrame = false;
 
+    ad.frameRate = 60.0f;
+    ad.idleTimeout = 0.5f;
+
+    ad.trace = false;
+    ad.traceFile = "data/trace.json";
+
+    ad.seed = 1u;
+    ad.recordFile = "";
+    ad.replayFile = "";
+
+    ad.headless = false;
+    ad.frames = 0u;
+    ad.snapshotFile = "";
+
     return ad;
   }
 
@@ -1,10 +1,54 @@
 #ifndef    COLOR_UTILS_HH
 # define   COLOR_UTILS_HH
 
+# include <cstdint>
 # include "olcEngine.hh"
 
 namespace pge {
 
+  namespace alpha {
+
+    constexpr int Opaque = 255;
+    constexpr int AlmostOpaque = 192;
+    constexpr int SemiOpaque = 128;
+    constexpr int AlmostTransparent = 64;
+    constexpr int Transparent = 0;
+
+  }
+
+  /**
+   * @brief - Pack the input channels in a single value
+   *          with the layout used by `olc::Pixel`. This
+   *          allows to manipulate colors at compile time
+   *          which can't be done with pixels.
+   * @param r - the red channel.
+   * @param g - the green channel.
+   * @param b - the blue channel.
+   * @param a - the alpha channel.
+   * @return - the packed color.
+   */
+  constexpr uint32_t
+  pack(int r, int g, int b, int a = alpha::Opaque) noexcept;
+
+  /**
+   * @brief - Interpolate linearly between two packed
+   *          colors. Can be evaluated at compile time.
+   * @param low - the color for a ratio of `0`.
+   * @param high - the color for a ratio of `1`.
+   * @param ratio - the interpolation ratio, clamped in
+   *                the range `[0; 1]`.
+   * @param alpha - the alpha channel of the output.
+   * @return - the interpolated color.
+   */
+  constexpr uint32_t
+  colorGradient(uint32_t low,
+                uint32_t high,
+                float ratio,
+                int alpha) noexcept;
+
+  /**
+   * @brief - Similar to the above method but for pixels.
+   */
   olc::Pixel
   colorGradient(const olc::Pixel& low,
                 const olc::Pixel& high,
@@ -35,6 +79,15 @@ namespace pge {
   olc::Pixel
   HSLToRGB(const olc::Pixel& hsl) noexcept;
 
+  /**
+   * @brief - Similar to the above method but for packed
+   *          colors. Can be evaluated at compile time.
+   * @param hsl - the packed color in `HSL` space.
+   * @return - the packed equivalent in `RGB` space.
+   */
+  constexpr uint32_t
+  HSLToRGB(uint32_t hsl) noexcept;
+
   /**
    * @brief - Modulate the lightness of the input color
    *          by the specified factor. We convert the
@@ -52,16 +105,6 @@ namespace pge {
   olc::Pixel
   modulate(const olc::Pixel& in, float factor) noexcept;
 
-  namespace alpha {
-
-    constexpr int Opaque = 255;
-    constexpr int AlmostOpaque = 192;
-    constexpr int SemiOpaque = 128;
-    constexpr int AlmostTransparent = 64;
-    constexpr int Transparent = 0;
-
-  }
-
 }
 
 /**
@@ -2,10 +2,38 @@
 # define   COLOR_UTILS_HXX
 
 # include "ColorUtils.hh"
+# include <algorithm>
 # include <maths_utils/ComparisonUtils.hh>
 
 namespace pge {
 
+  constexpr
+  uint32_t
+  pack(int r, int g, int b, int a) noexcept {
+    return
+      static_cast<uint32_t>(r & 0xFF) |
+      (static_cast<uint32_t>(g & 0xFF) << 8u) |
+      (static_cast<uint32_t>(b & 0xFF) << 16u) |
+      (static_cast<uint32_t>(a & 0xFF) << 24u)
+    ;
+  }
+
+  constexpr
+  uint32_t
+  colorGradient(uint32_t low,
+                uint32_t high,
+                float ratio,
+                int alpha) noexcept
+  {
+    ratio = std::clamp(ratio, 0.0f, 1.0f);
+
+    float r = (1.0f - ratio) * (low & 0xFFu) + ratio * (high & 0xFFu);
+    float g = (1.0f - ratio) * ((low >> 8u) & 0xFFu) + ratio * ((high >> 8u) & 0xFFu);
+    float b = (1.0f - ratio) * ((low >> 16u) & 0xFFu) + ratio * ((high >> 16u) & 0xFFu);
+
+    return pack(static_cast<int>(r), static_cast<int>(g), static_cast<int>(b), alpha);
+  }
+
   inline
   olc::Pixel
   colorGradient(const olc::Pixel& low,
@@ -13,14 +41,7 @@ namespace pge {
                 float ratio,
                 int alpha) noexcept
   {
-    ratio = utils::clamp(ratio, 0.0f, 1.0f);
-
-    return olc::Pixel(
-      static_cast<int>((1.0f - ratio) * low.r + ratio * high.r),
-      static_cast<int>((1.0f - ratio) * low.g + ratio * high.g),
-      static_cast<int>((1.0f - ratio) * low.b + ratio * high.b),
-      alpha
-    );
+    return olc::Pixel(colorGradient(low.n, high.n, ratio, alpha));
   }
 
   inline
@@ -73,17 +94,24 @@ namespace pge {
     return olc::Pixel(h, s, l, rgb.a);
   }
 
-  inline
-  olc::Pixel
-  HSLToRGB(const olc::Pixel& hsl) noexcept {
+  constexpr
+  uint32_t
+  HSLToRGB(uint32_t hsl) noexcept {
     // See here for more info:
     // https://www.rapidtables.com/convert/color/hsl-to-rgb.html
-    float h = 360.0f * hsl.r / 255.0f;
-    float s = hsl.g / 255.0f;
-    float l = hsl.b / 255.0f;
+    float h = 360.0f * (hsl & 0xFFu) / 255.0f;
+    float s = ((hsl >> 8u) & 0xFFu) / 255.0f;
+    float l = ((hsl >> 16u) & 0xFFu) / 255.0f;
 
-    float C = (1.0f - std::abs(2.0f * l - 1.0f)) * s;
-    float X = C * (1.0f - std::abs(std::fmod(h / 60.0f, 2.0f) - 1.0f));
+    // `std::abs` and `std::fmod` can't be evaluated at
+    // compile time: as `h` is positive the remainder
+    // is computed from the truncated quotient.
+    auto abs = [](float v) { return (v < 0.0f ? -v : v); };
+    float q = h / 60.0f;
+    float mod = q - 2.0f * static_cast<int>(q / 2.0f);
+
+    float C = (1.0f - abs(2.0f * l - 1.0f)) * s;
+    float X = C * (1.0f - abs(mod - 1.0f));
 
     float m = l - C / 2.0f;
 
@@ -107,11 +135,17 @@ namespace pge {
       R = C; G = 0.0f; B = X;
     }
 
-    int r = utils::clamp(static_cast<int>((R + m) * 255.0f), 0, 255);
-    int g = utils::clamp(static_cast<int>((G + m) * 255.0f), 0, 255);
-    int b = utils::clamp(static_cast<int>((B + m) * 255.0f), 0, 255);
+    int r = std::clamp(static_cast<int>((R + m) * 255.0f), 0, 255);
+    int g = std::clamp(static_cast<int>((G + m) * 255.0f), 0, 255);
+    int b = std::clamp(static_cast<int>((B + m) * 255.0f), 0, 255);
 
-    return olc::Pixel(r, g, b, hsl.a);
+    return pack(r, g, b, static_cast<int>(hsl >> 24u));
+  }
+
+  inline
+  olc::Pixel
+  HSLToRGB(const olc::Pixel& hsl) noexcept {
+    return olc::Pixel(HSLToRGB(hsl.n));
   }
 
   inline
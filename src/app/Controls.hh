@@ -2,6 +2,7 @@
 # define   CONTROLS_HH
 
 # include <vector>
+# include <core_utils/TimeUtils.hh>
 
 namespace pge {
   namespace controls {
@@ -61,10 +62,28 @@ namespace pge {
       Held
     };
 
+    /**
+     * @brief - A change of state of one of the tracked keys
+     *          as received from the system.
+     */
+    struct KeyEvent {
+      // The key which changed.
+      keys::Keys key;
+
+      // Whether the key was pressed or released.
+      bool pressed;
+
+      // The time at which the event was received.
+      utils::TimeStamp time;
+    };
+
     /**
      * @brief - Describe a structure holding the controls
      *          that are relevant extracted from the keys
      *          pressed by the user and the mouse info.
+     *          The events of the keys received since the
+     *          last frame are also provided in order so
+     *          that quick taps are not missed.
      */
     struct State {
       int mPosX;
@@ -74,6 +93,8 @@ namespace pge {
       std::vector<ButtonState> buttons;
 
       bool tab;
+
+      std::vector<KeyEvent> events;
     };
 
     /**
@@ -19,6 +19,8 @@ namespace pge {
 
       c.tab = false;
 
+      c.events.clear();
+
       return c;
     }
 
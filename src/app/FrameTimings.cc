@@ -0,0 +1,147 @@
+
+# include "FrameTimings.hh"
+# include <cstdio>
+# include "Tracer.hh"
+
+/// @brief - The height in pixels of a row of text in the overlay.
+# define ROW_HEIGHT 10
+
+/// @brief - The height in pixels of the graph of the durations of
+/// the frames.
+# define GRAPH_HEIGHT 64
+
+/// @brief - The number of pixels representing a millisecond in the
+/// graph: longer frames are clamped to the top of the graph.
+# define GRAPH_PIXELS_PER_MS 2.0f
+
+namespace {
+
+  /// @brief - The display names of the phases.
+  const char* const PHASE_NAMES[pge::timings::PhasesCount] = {
+    "handle inputs",
+    "on inputs",
+    "on frame",
+    "draw decal",
+    "draw",
+    "draw ui",
+    "draw debug",
+    "frame"
+  };
+
+}
+
+namespace pge {
+
+  FrameTimings::FrameTimings() noexcept:
+    m_start(utils::now()),
+    m_last(m_start),
+
+    m_current(),
+    m_samples(),
+    m_count(0u),
+
+    m_scratch()
+  {
+    m_current.fill(0.0f);
+  }
+
+  void
+  FrameTimings::mark(const timings::Phase& phase) noexcept {
+    utils::TimeStamp t = utils::now();
+
+    m_current[phase] = utils::diffInMs(m_last, t);
+    profiling::Tracer::record(PHASE_NAMES[phase], "frame", m_last, t);
+
+    m_last = t;
+  }
+
+  void
+  FrameTimings::end() noexcept {
+    utils::TimeStamp t = utils::now();
+
+    m_current[timings::Frame] = utils::diffInMs(m_start, t);
+    profiling::Tracer::record(PHASE_NAMES[timings::Frame], "frame", m_start, t);
+
+    // Only the rendering thread writes in the buffer so
+    // the counter can't change in the meantime.
+    unsigned count = m_count.load(std::memory_order_relaxed);
+    m_samples[count % History] = m_current;
+    m_count.store(count + 1u, std::memory_order_release);
+  }
+
+  timings::Stats
+  FrameTimings::stats(const timings::Phase& phase) const noexcept {
+    unsigned count = m_count.load(std::memory_order_acquire);
+    unsigned n = std::min(count, History - 1u);
+    if (n == 0u) {
+      return timings::Stats{0.0f, 0.0f, 0.0f};
+    }
+
+    for (unsigned id = 0u ; id < n ; ++id) {
+      m_scratch[id] = sample(count, id)[phase];
+    }
+
+    // Partial sorts are enough to find the percentiles.
+    float* first = m_scratch.data();
+    float* last = first + n;
+
+    unsigned p99 = std::min(n - 1u, (99u * n + 99u) / 100u - 1u);
+    std::nth_element(first, first + p99, last);
+    float v99 = m_scratch[p99];
+
+    // The median is among the values below the percentile.
+    float v50 = v99;
+    if (n / 2u < p99) {
+      std::nth_element(first, first + n / 2u, first + p99);
+      v50 = m_scratch[n / 2u];
+    }
+
+    return timings::Stats{v50, v99, *std::max_element(first + p99, last)};
+  }
+
+  std::string
+  FrameTimings::summary(const timings::Phase& phase) const {
+    char buf[64];
+
+    timings::Stats s = stats(phase);
+    std::snprintf(buf, sizeof(buf), "%-13s %8.3f%8.3f%8.3f", PHASE_NAMES[phase], s.p50, s.p99, s.max);
+
+    return buf;
+  }
+
+  void
+  FrameTimings::render(olc::PixelGameEngine* pge,
+                       const olc::vi2d& pos,
+                       float budget) const
+  {
+    pge->DrawString(pos, "phase              p50     p99     max (ms)", olc::CYAN);
+
+    for (unsigned id = 0u ; id < timings::PhasesCount ; ++id) {
+      std::string line = summary(static_cast<timings::Phase>(id));
+      pge->DrawString(pos + olc::vi2d(0, (id + 1) * ROW_HEIGHT), line, olc::CYAN);
+    }
+
+    // The graph of the duration of the last frames, the most
+    // recent one being on the right.
+    olc::vi2d gp = pos + olc::vi2d(0, (timings::PhasesCount + 1) * ROW_HEIGHT + ROW_HEIGHT / 2);
+    int bottom = gp.y + GRAPH_HEIGHT - 1;
+    pge->FillRect(gp, olc::vi2d(History, GRAPH_HEIGHT), olc::Pixel(0, 0, 0, 128));
+
+    unsigned count = m_count.load(std::memory_order_acquire);
+    unsigned n = std::min(count, History - 1u);
+
+    for (unsigned id = 0u ; id < n ; ++id) {
+      float d = sample(count, id)[timings::Frame];
+      int h = static_cast<int>(std::min(d * GRAPH_PIXELS_PER_MS, GRAPH_HEIGHT - 1.0f));
+
+      int x = gp.x + static_cast<int>(History - n + id);
+      pge->DrawLine(x, bottom, x, bottom - h, d > budget ? olc::RED : olc::GREEN);
+    }
+
+    int by = bottom - static_cast<int>(budget * GRAPH_PIXELS_PER_MS);
+    if (budget > 0.0f && by >= gp.y) {
+      pge->DrawLine(gp.x, by, gp.x + History - 1, by, olc::YELLOW);
+    }
+  }
+
+}
@@ -0,0 +1,175 @@
+#ifndef    FRAME_TIMINGS_HH
+# define   FRAME_TIMINGS_HH
+
+# include <array>
+# include <string>
+# include <algorithm>
+# include <atomic>
+# include <core_utils/TimeUtils.hh>
+# include "olcEngine.hh"
+
+namespace pge {
+  namespace timings {
+
+    /**
+     * @brief - The phases of a frame which are measured. The
+     *          `Frame` phase covers the whole frame.
+     */
+    enum Phase {
+      HandleInputs,
+      OnInputs,
+      OnFrame,
+      DrawDecal,
+      Draw,
+      DrawUI,
+      DrawDebug,
+      Frame,
+
+      PhasesCount
+    };
+
+    /// @brief - Rolling statistics of the duration of a phase in
+    /// milliseconds.
+    struct Stats {
+      float p50;
+      float p99;
+      float max;
+    };
+
+  }
+
+  /// @brief - Measures the duration of the phases of each frame
+  /// and keeps the measures of the last frames in a ring buffer.
+  /// The buffer has a single producer (the rendering thread) and
+  /// is lock-free: the number of frames recorded is published
+  /// with an atomic counter once the measures of a frame are
+  /// written, so that it can be read from any thread. Readers
+  /// ignore the oldest slot as it is the one being written.
+  /// The phases are also recorded as spans by the `Tracer`.
+  class FrameTimings {
+    public:
+
+      /// @brief - The number of frames kept in the ring buffer.
+      static constexpr unsigned History = 256u;
+
+      /**
+       * @brief - Create a new empty history of timings.
+       */
+      FrameTimings() noexcept;
+
+      /**
+       * @brief - Start the measures of a new frame.
+       */
+      void
+      begin() noexcept;
+
+      /**
+       * @brief - Mark the end of a phase of the current frame: the
+       *          time elapsed since the end of the previous phase is
+       *          accounted to it.
+       * @param phase - the phase which just completed.
+       */
+      void
+      mark(const timings::Phase& phase) noexcept;
+
+      /**
+       * @brief - Complete the measures of the current frame and
+       *          publish them in the ring buffer.
+       */
+      void
+      end() noexcept;
+
+      /**
+       * @brief - The number of frames available in the history.
+       * @return - the number of frames that can be read.
+       */
+      unsigned
+      size() const noexcept;
+
+      /**
+       * @brief - Compute the median, the 99th percentile and the
+       *          maximum duration of a phase over the history.
+       * @param phase - the phase to analyze.
+       * @return - the statistics in milliseconds.
+       */
+      timings::Stats
+      stats(const timings::Phase& phase) const noexcept;
+
+      /**
+       * @brief - Format the statistics of a phase as a line of text
+       *          holding its name, the median, the 99th percentile
+       *          and the maximum duration in milliseconds.
+       * @param phase - the phase to format.
+       * @return - the line describing the phase.
+       */
+      std::string
+      summary(const timings::Phase& phase) const;
+
+      /**
+       * @brief - Render the statistics of each phase and a graph
+       *          of the duration of the last frames.
+       * @param pge - the engine to use to perform the rendering.
+       * @param pos - the top left corner of the overlay.
+       * @param budget - the target duration of a frame in ms. A
+       *                 line is drawn at this level in the graph
+       *                 and frames exceeding it are highlighted.
+       */
+      void
+      render(olc::PixelGameEngine* pge,
+             const olc::vi2d& pos,
+             float budget) const;
+
+    private:
+
+      /// @brief - The measures of a single frame in milliseconds.
+      using Sample = std::array<float, timings::PhasesCount>;
+
+      /**
+       * @brief - Access the sample of a frame of the history.
+       * @param count - the number of frames recorded, as returned
+       *                by the counter of the buffer.
+       * @param id - the index of the frame, `0` being the oldest
+       *             available one.
+       * @return - the sample of this frame.
+       */
+      const Sample&
+      sample(unsigned count, unsigned id) const noexcept;
+
+    private:
+
+      /**
+       * @brief - The start of the current frame and the end of the
+       *          last phase measured.
+       */
+      utils::TimeStamp m_start;
+      utils::TimeStamp m_last;
+
+      /**
+       * @brief - The measures of the current frame, copied in the
+       *          ring buffer when it completes.
+       */
+      Sample m_current;
+
+      /**
+       * @brief - The ring buffer of the measures of the frames.
+       */
+      std::array<Sample, History> m_samples;
+
+      /**
+       * @brief - The total number of frames published in the ring
+       *          buffer.
+       */
+      std::atomic<unsigned> m_count;
+
+      /**
+       * @brief - Storage used to sort the durations of a phase when
+       *          computing statistics, which avoids to allocate it.
+       */
+      mutable std::array<float, History> m_scratch;
+  };
+
+}
+
+# include "FrameTimings.hxx"
+
+#endif    /* FRAME_TIMINGS_HH */
@@ -0,0 +1,32 @@
+#ifndef    FRAME_TIMINGS_HXX
+# define   FRAME_TIMINGS_HXX
+
+# include "FrameTimings.hh"
+
+namespace pge {
+
+  inline
+  void
+  FrameTimings::begin() noexcept {
+    m_start = utils::now();
+    m_last = m_start;
+    m_current.fill(0.0f);
+  }
+
+  inline
+  unsigned
+  FrameTimings::size() const noexcept {
+    unsigned count = m_count.load(std::memory_order_acquire);
+    return std::min(count, History - 1u);
+  }
+
+  inline
+  const FrameTimings::Sample&
+  FrameTimings::sample(unsigned count, unsigned id) const noexcept {
+    unsigned available = std::min(count, History - 1u);
+    return m_samples[(count - available + id) % History];
+  }
+
+}
+
+#endif    /* FRAME_TIMINGS_HXX */
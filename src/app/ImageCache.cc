@@ -0,0 +1,263 @@
+
+# include "ImageCache.hh"
+# include <algorithm>
+# include "Tracer.hh"
+
+/// @brief - The maximum number of threads decoding images in
+/// the background.
+# define MAX_DECODING_WORKERS 4u
+
+namespace pge {
+
+  Image::Image():
+    m_sprite(nullptr),
+    m_decal(nullptr),
+    m_ready(false)
+  {}
+
+  Image::Image(olc::Sprite* sprite):
+    m_sprite(sprite),
+    m_decal(nullptr),
+    m_ready(true)
+  {}
+
+  Image::~Image() {
+    release();
+  }
+
+  void
+  Image::upload(olc::Sprite* sprite) {
+    release();
+
+    m_sprite = sprite;
+    m_ready = true;
+  }
+
+  olc::Decal*
+  Image::decal() {
+    if (m_decal == nullptr && m_sprite != nullptr) {
+      m_decal = new olc::Decal(m_sprite);
+    }
+
+    return m_decal;
+  }
+
+  void
+  Image::release() noexcept {
+    if (m_decal != nullptr) {
+      delete m_decal;
+    }
+    if (m_sprite != nullptr) {
+      delete m_sprite;
+    }
+
+    m_decal = nullptr;
+    m_sprite = nullptr;
+  }
+
+  ImageCache&
+  ImageCache::instance() {
+    static ImageCache cache;
+    return cache;
+  }
+
+  ImageCache::ImageCache():
+    utils::CoreObject("images"),
+
+    m_images(),
+
+    m_locker(),
+    m_notifier(),
+    m_running(false),
+
+    m_pending(),
+    m_decoded(),
+    m_loading(0u),
+
+    m_workers()
+  {
+    setService("textures");
+  }
+
+  ImageCache::~ImageCache() {
+    stopWorkers();
+  }
+
+  ImageShPtr
+  ImageCache::load(const std::string& file) {
+    std::unordered_map<std::string, ImageShPtr>::const_iterator it = m_images.find(file);
+    if (it != m_images.cend()) {
+      return it->second;
+    }
+
+    // Failing to load the file produces an empty sprite.
+    olc::Sprite* spr = new olc::Sprite(file);
+    if (spr->width <= 0 || spr->height <= 0) {
+      warn("Failed to load image \"" + file + "\"");
+      delete spr;
+
+      return nullptr;
+    }
+
+    ImageShPtr img = std::make_shared<Image>(spr);
+    m_images[file] = img;
+
+    verbose("Loaded image \"" + file + "\" (" + std::to_string(m_images.size()) + " image(s) in cache)");
+
+    return img;
+  }
+
+  ImageShPtr
+  ImageCache::loadAsync(const std::string& file) {
+    std::unordered_map<std::string, ImageShPtr>::const_iterator it = m_images.find(file);
+    if (it != m_images.cend()) {
+      return it->second;
+    }
+
+    // Register the image right away so that other users of
+    // the file share the pending image.
+    ImageShPtr img = std::make_shared<Image>();
+    m_images[file] = img;
+
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+
+      startWorkers();
+      m_pending.push_back(Job{img, file, nullptr});
+      ++m_loading;
+    }
+
+    m_notifier.notify_one();
+
+    return img;
+  }
+
+  unsigned
+  ImageCache::upload() {
+    std::vector<Job> decoded;
+
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      if (m_decoded.empty()) {
+        return 0u;
+      }
+
+      decoded.swap(m_decoded);
+      m_loading -= decoded.size();
+    }
+
+    profiling::Span span("upload images", "resources");
+
+    for (unsigned id = 0u ; id < decoded.size() ; ++id) {
+      Job& job = decoded[id];
+
+      if (job.sprite == nullptr) {
+        warn("Failed to load image \"" + job.file + "\"");
+      }
+
+      job.image->upload(job.sprite);
+    }
+
+    verbose("Uploaded " + std::to_string(decoded.size()) + " image(s)");
+
+    return decoded.size();
+  }
+
+  void
+  ImageCache::clear() {
+    stopWorkers();
+
+    for (std::pair<const std::string, ImageShPtr>& img : m_images) {
+      img.second->release();
+    }
+
+    m_images.clear();
+  }
+
+  void
+  ImageCache::startWorkers() {
+    if (m_running) {
+      return;
+    }
+
+    m_running = true;
+
+    unsigned count = std::max(std::thread::hardware_concurrency(), 1u);
+    count = std::min(count, MAX_DECODING_WORKERS);
+
+    for (unsigned id = 0u ; id < count ; ++id) {
+      m_workers.push_back(std::thread(&ImageCache::run, this));
+    }
+  }
+
+  void
+  ImageCache::stopWorkers() {
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      m_running = false;
+      m_pending.clear();
+    }
+
+    m_notifier.notify_all();
+
+    for (unsigned id = 0u ; id < m_workers.size() ; ++id) {
+      m_workers[id].join();
+    }
+    m_workers.clear();
+
+    // Sprites decoded but not uploaded are not needed anymore.
+    for (unsigned id = 0u ; id < m_decoded.size() ; ++id) {
+      delete m_decoded[id].sprite;
+    }
+
+    m_decoded.clear();
+    m_loading = 0u;
+  }
+
+  void
+  ImageCache::run() {
+    std::unique_lock<std::mutex> lock(m_locker);
+
+    while (m_running) {
+      m_notifier.wait(
+        lock,
+        [this]() {
+          return !m_running || !m_pending.empty();
+        }
+      );
+
+      if (!m_running) {
+        break;
+      }
+
+      Job job = m_pending.front();
+      m_pending.pop_front();
+
+      // Decode without holding the lock so that other images
+      // can be decoded in the meantime.
+      lock.unlock();
+
+      {
+        profiling::Span span("decode image", "resources");
+
+        // Failing to load the file produces an empty sprite.
+        job.sprite = new olc::Sprite(job.file);
+        if (job.sprite->width <= 0 || job.sprite->height <= 0) {
+          delete job.sprite;
+          job.sprite = nullptr;
+        }
+      }
+
+      lock.lock();
+
+      // The cache might have been cleared in the meantime.
+      if (!m_running) {
+        delete job.sprite;
+        break;
+      }
+
+      m_decoded.push_back(job);
+    }
+  }
+
+}
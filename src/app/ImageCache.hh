@@ -0,0 +1,273 @@
+#ifndef    IMAGE_CACHE_HH
+# define   IMAGE_CACHE_HH
+
+# include <deque>
+# include <mutex>
+# include <memory>
+# include <string>
+# include <thread>
+# include <vector>
+# include <unordered_map>
+# include <condition_variable>
+# include <core_utils/CoreObject.hh>
+# include "olcEngine.hh"
+
+namespace pge {
+
+  /// @brief - An image loaded from a file along with the texture
+  /// created from it. Images are owned by the `ImageCache`: their
+  /// resources are released when the cache is cleared even if the
+  /// image is still referenced, in which case the decal is `null`.
+  /// The decal is also `null` while the image is being decoded in
+  /// the background.
+  /// The texture is only created when the decal is first requested
+  /// so that images which are only drawn through an atlas do not
+  /// use any memory on the GPU.
+  class Image {
+    public:
+
+      /**
+       * @brief - Create a new image waiting for its data: it can
+       *          be drawn once `upload` is called.
+       */
+      Image();
+
+      /**
+       * @brief - Create a new image from the input sprite.
+       * @param sprite - the sprite of the image, the image takes
+       *                 ownership of it.
+       */
+      Image(olc::Sprite* sprite);
+
+      /**
+       * @brief - Release the resources of the image.
+       */
+      ~Image();
+
+      Image(const Image&) = delete;
+
+      Image&
+      operator=(const Image&) = delete;
+
+      /**
+       * @brief - The decal allowing to draw the image. It is created
+       *          on the first call, which should happen from the
+       *          rendering thread.
+       * @return - the decal or `null` if the image is not loaded.
+       */
+      olc::Decal*
+      decal();
+
+      /**
+       * @brief - The data of the image in memory.
+       * @return - the sprite or `null` if the image is not loaded.
+       */
+      olc::Sprite*
+      sprite() const noexcept;
+
+      /**
+       * @brief - Whether the data of the image is available, i.e.
+       *          the image was decoded or its loading failed.
+       * @return - `true` if the image is not waiting for its data.
+       */
+      bool
+      ready() const noexcept;
+
+      /**
+       * @brief - Attach the data of the image. Should be called
+       *          from the rendering thread.
+       * @param sprite - the decoded sprite, the image takes the
+       *                 ownership of it. `null` indicates that the
+       *                 loading failed.
+       */
+      void
+      upload(olc::Sprite* sprite);
+
+      /**
+       * @brief - Release the sprite and the texture of the image.
+       *          Should be called while the rendering context is
+       *          still valid.
+       */
+      void
+      release() noexcept;
+
+    private:
+
+      /**
+       * @brief - The data of the image and its texture, which is
+       *          `null` until it is requested.
+       */
+      olc::Sprite* m_sprite;
+      olc::Decal* m_decal;
+
+      /**
+       * @brief - Whether the data of the image is available.
+       */
+      bool m_ready;
+  };
+
+  using ImageShPtr = std::shared_ptr<Image>;
+
+  /// @brief - Cache of the images loaded from files: each file is
+  /// only decoded and uploaded to the GPU once, no matter how many
+  /// elements use it. The lifetime of the images is tied to the
+  /// cache: they are kept until the cache is cleared, even if no
+  /// element uses them anymore.
+  /// Images can also be decoded by a pool of workers: they are then
+  /// handed to the rendering thread when calling the `upload` method.
+  /// The cache is shared by all the elements of the application and
+  /// should only be used from the rendering thread.
+  class ImageCache: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Access the cache of the application.
+       * @return - the cache of images.
+       */
+      static ImageCache&
+      instance();
+
+      /**
+       * @brief - Returns the image loaded from the input file,
+       *          loading it if this was not already done.
+       * @param file - the path to the image.
+       * @return - the image or `null` if it can't be loaded.
+       */
+      ImageShPtr
+      load(const std::string& file);
+
+      /**
+       * @brief - Similar to `load` but the file is decoded in the
+       *          background: the returned image does not have any
+       *          decal until it is uploaded by the `upload` method.
+       *          Failure to load the image is reported by a warning
+       *          and the image keeps a `null` decal.
+       * @param file - the path to the image.
+       * @return - the image, which may not be ready yet.
+       */
+      ImageShPtr
+      loadAsync(const std::string& file);
+
+      /**
+       * @brief - Attach the sprites decoded since the last call to
+       *          their image. Should be called once per frame from
+       *          the rendering thread.
+       * @return - the number of images which became ready.
+       */
+      unsigned
+      upload();
+
+      /**
+       * @brief - Whether some images are still being decoded or
+       *          waiting to be uploaded.
+       * @return - `true` if some images are not ready yet.
+       */
+      bool
+      loading() const noexcept;
+
+      /**
+       * @brief - Release all the images, including the ones still
+       *          referenced. Should be called before the rendering
+       *          context is destroyed. Pending decodings are also
+       *          discarded.
+       */
+      void
+      clear();
+
+    private:
+
+      /// @brief - An image to decode or decoded by the workers.
+      struct Job {
+        // The image waiting for its data.
+        ImageShPtr image;
+
+        // The path to the file to decode.
+        std::string file;
+
+        // The decoded sprite, `null` until it is decoded or if
+        // the decoding failed.
+        olc::Sprite* sprite;
+      };
+
+      /**
+       * @brief - Create a new empty cache.
+       */
+      ImageCache();
+
+      /**
+       * @brief - Stop the workers and discard the pending jobs.
+       */
+      ~ImageCache();
+
+      /**
+       * @brief - Start the workers if they are not running yet.
+       *          Assumes that the locker is already acquired.
+       */
+      void
+      startWorkers();
+
+      /**
+       * @brief - Stop the workers and release the sprites which
+       *          were decoded but not uploaded yet.
+       */
+      void
+      stopWorkers();
+
+      /**
+       * @brief - Main loop of the workers: decode images as long
+       *          as some are pending.
+       */
+      void
+      run();
+
+    private:
+
+      /**
+       * @brief - The images loaded so far, indexed by the path of
+       *          their file.
+       */
+      std::unordered_map<std::string, ImageShPtr> m_images;
+
+      /**
+       * @brief - Protects the jobs from concurrent accesses.
+       */
+      mutable std::mutex m_locker;
+
+      /**
+       * @brief - Notified when new jobs are available or when the
+       *          workers should stop.
+       */
+      std::condition_variable m_notifier;
+
+      /**
+       * @brief - Whether the workers should keep running.
+       */
+      bool m_running;
+
+      /**
+       * @brief - The images waiting to be decoded.
+       */
+      std::deque<Job> m_pending;
+
+      /**
+       * @brief - The images decoded and waiting to be uploaded.
+       */
+      std::vector<Job> m_decoded;
+
+      /**
+       * @brief - The number of images not uploaded yet.
+       */
+      unsigned m_loading;
+
+      /**
+       * @brief - The workers decoding the images. They are only
+       *          started when an image is loaded asynchronously.
+       */
+      std::vector<std::thread> m_workers;
+  };
+
+}
+
+# include "ImageCache.hxx"
+
+#endif    /* IMAGE_CACHE_HH */
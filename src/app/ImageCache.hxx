@@ -0,0 +1,29 @@
+#ifndef    IMAGE_CACHE_HXX
+# define   IMAGE_CACHE_HXX
+
+# include "ImageCache.hh"
+
+namespace pge {
+
+  inline
+  olc::Sprite*
+  Image::sprite() const noexcept {
+    return m_sprite;
+  }
+
+  inline
+  bool
+  Image::ready() const noexcept {
+    return m_ready;
+  }
+
+  inline
+  bool
+  ImageCache::loading() const noexcept {
+    std::lock_guard<std::mutex> guard(m_locker);
+    return m_loading > 0u;
+  }
+
+}
+
+#endif    /* IMAGE_CACHE_HXX */
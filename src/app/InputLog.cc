@@ -0,0 +1,190 @@
+
+# include "InputLog.hh"
+# include <cstdint>
+
+/// @brief - The identifier at the beginning of the recordings.
+# define INPUT_LOG_MAGIC 0x54504e49u
+
+/// @brief - The version of the format of the recordings.
+# define INPUT_LOG_VERSION 1u
+
+/// @brief - The bit of the mask of the keys holding the state
+/// of the `tab` key.
+# define TAB_BIT 15u
+
+namespace {
+
+  static_assert(pge::controls::keys::KeysCount <= TAB_BIT, "Keys don't fit in the mask of a frame");
+  static_assert(pge::controls::mouse::ButtonsCount * 2u <= 8u, "Buttons don't fit in the mask of a frame");
+
+  template <typename T>
+  void
+  write(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool
+  read(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+  }
+
+}
+
+namespace pge {
+
+  InputRecorder::InputRecorder(const std::string& file, unsigned seed):
+    utils::CoreObject("recorder"),
+
+    m_file(file),
+    m_out(file.c_str(), std::ios::binary),
+    m_frames(0u)
+  {
+    setService("inputs");
+
+    if (!m_out.good()) {
+      error(
+        "Failed to record inputs to \"" + file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    write(m_out, uint32_t(INPUT_LOG_MAGIC));
+    write(m_out, uint32_t(INPUT_LOG_VERSION));
+    write(m_out, uint32_t(seed));
+
+    info("Recording inputs to \"" + m_file + "\" with seed " + std::to_string(seed));
+  }
+
+  InputRecorder::~InputRecorder() {
+    m_out.flush();
+    info("Recorded " + std::to_string(m_frames) + " frame(s) to \"" + m_file + "\"");
+  }
+
+  void
+  InputRecorder::record(float elapsed, int scroll, const controls::State& c) {
+    // Each frame is written as the duration of the frame,
+    // the position of the mouse, a mask of the keys and one
+    // of the buttons, the scroll and the events of the keys.
+    uint16_t keys = 0u;
+    for (unsigned id = 0u ; id < c.keys.size() ; ++id) {
+      keys |= (c.keys[id] ? 1u << id : 0u);
+    }
+    keys |= (c.tab ? 1u << TAB_BIT : 0u);
+
+    uint8_t buttons = 0u;
+    for (unsigned id = 0u ; id < c.buttons.size() ; ++id) {
+      buttons |= static_cast<unsigned>(c.buttons[id]) << (2u * id);
+    }
+
+    write(m_out, elapsed);
+    write(m_out, static_cast<int16_t>(c.mPosX));
+    write(m_out, static_cast<int16_t>(c.mPosY));
+    write(m_out, keys);
+    write(m_out, buttons);
+    write(m_out, static_cast<int8_t>(scroll > 0 ? 1 : (scroll < 0 ? -1 : 0)));
+
+    write(m_out, static_cast<uint16_t>(c.events.size()));
+    for (unsigned id = 0u ; id < c.events.size() ; ++id) {
+      const controls::KeyEvent& e = c.events[id];
+      write(m_out, static_cast<uint8_t>((e.key << 1u) | (e.pressed ? 1u : 0u)));
+    }
+
+    ++m_frames;
+  }
+
+  InputPlayer::InputPlayer(const std::string& file):
+    utils::CoreObject("player"),
+
+    m_file(file),
+    m_in(file.c_str(), std::ios::binary),
+    m_seed(0u),
+    m_frames(0u)
+  {
+    setService("inputs");
+
+    if (!m_in.good()) {
+      error(
+        "Failed to replay inputs from \"" + file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    uint32_t magic = 0u, version = 0u, seed = 0u;
+    if (!read(m_in, magic) || !read(m_in, version) || !read(m_in, seed)) {
+      error(
+        "Failed to replay inputs from \"" + file + "\"",
+        "Truncated header"
+      );
+    }
+
+    if (magic != INPUT_LOG_MAGIC || version != INPUT_LOG_VERSION) {
+      error(
+        "Failed to replay inputs from \"" + file + "\"",
+        "Unsupported recording with version " + std::to_string(version)
+      );
+    }
+
+    m_seed = seed;
+
+    info("Replaying inputs from \"" + m_file + "\" with seed " + std::to_string(m_seed));
+  }
+
+  bool
+  InputPlayer::next(float& elapsed, int& scroll, controls::State& c) {
+    int16_t x, y;
+    uint16_t keys;
+    uint8_t buttons;
+    int8_t wheel;
+    uint16_t count;
+
+    bool valid =
+      read(m_in, elapsed) &&
+      read(m_in, x) &&
+      read(m_in, y) &&
+      read(m_in, keys) &&
+      read(m_in, buttons) &&
+      read(m_in, wheel) &&
+      read(m_in, count)
+    ;
+
+    c.events.clear();
+    utils::TimeStamp now = utils::now();
+
+    for (unsigned id = 0u ; id < count && valid ; ++id) {
+      uint8_t e = 0u;
+      valid = read(m_in, e);
+
+      c.events.push_back(
+        controls::KeyEvent{static_cast<controls::keys::Keys>(e >> 1u), (e & 1u) != 0u, now}
+      );
+    }
+
+    // A truncated frame ends the replay.
+    if (!valid) {
+      c.events.clear();
+      info("Replayed " + std::to_string(m_frames) + " frame(s) from \"" + m_file + "\"");
+
+      return false;
+    }
+
+    c.mPosX = x;
+    c.mPosY = y;
+
+    for (unsigned id = 0u ; id < c.keys.size() ; ++id) {
+      c.keys[id] = ((keys >> id) & 1u) != 0u;
+    }
+    c.tab = ((keys >> TAB_BIT) & 1u) != 0u;
+
+    for (unsigned id = 0u ; id < c.buttons.size() ; ++id) {
+      c.buttons[id] = static_cast<controls::ButtonState>((buttons >> (2u * id)) & 3u);
+    }
+
+    scroll = wheel;
+    ++m_frames;
+
+    return true;
+  }
+
+}
@@ -0,0 +1,126 @@
+#ifndef    INPUT_LOG_HH
+# define   INPUT_LOG_HH
+
+# include <memory>
+# include <string>
+# include <fstream>
+# include <core_utils/CoreObject.hh>
+# include "Controls.hh"
+
+namespace pge {
+
+  /// @brief - Records the inputs of each frame to a binary file so
+  /// that a session can be replayed with an `InputPlayer`. Along
+  /// with the controls, the duration of the frame and the scroll of
+  /// the mouse are saved, as well as the seed of the random number
+  /// generator used by the session.
+  /// Frames are written as they are recorded, so the file is usable
+  /// even if the application does not exit cleanly.
+  class InputRecorder: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new recorder writing to the input file.
+       *          An error is raised if the file can't be opened.
+       * @param file - the path to the file to create.
+       * @param seed - the seed of the random number generator.
+       */
+      InputRecorder(const std::string& file, unsigned seed);
+
+      /**
+       * @brief - Flush the recorded frames to the file.
+       */
+      ~InputRecorder();
+
+      /**
+       * @brief - Record the inputs of a frame.
+       * @param elapsed - the duration of the frame in seconds.
+       * @param scroll - the scroll of the mouse wheel.
+       * @param c - the controls of the frame.
+       */
+      void
+      record(float elapsed, int scroll, const controls::State& c);
+
+    private:
+
+      /**
+       * @brief - The path to the file.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The stream to the file.
+       */
+      std::ofstream m_out;
+
+      /**
+       * @brief - The number of frames recorded so far.
+       */
+      unsigned m_frames;
+  };
+
+  using InputRecorderShPtr = std::shared_ptr<InputRecorder>;
+
+  /// @brief - Replays the inputs recorded by an `InputRecorder`,
+  /// one frame at a time.
+  class InputPlayer: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Open the recording saved in the input file. An
+       *          error is raised if the file is not a recording.
+       * @param file - the path to the recording.
+       */
+      InputPlayer(const std::string& file);
+
+      /**
+       * @brief - The seed of the random number generator used by
+       *          the recorded session.
+       * @return - the seed.
+       */
+      unsigned
+      seed() const noexcept;
+
+      /**
+       * @brief - Read the inputs of the next frame. The events of
+       *          the keys are timestamped with the current time.
+       * @param elapsed - output argument receiving the duration of
+       *                  the frame in seconds.
+       * @param scroll - output argument receiving the scroll of the
+       *                 mouse wheel.
+       * @param c - output argument receiving the controls.
+       * @return - `false` if the recording is over.
+       */
+      bool
+      next(float& elapsed, int& scroll, controls::State& c);
+
+    private:
+
+      /**
+       * @brief - The path to the recording.
+       */
+      std::string m_file;
+
+      /**
+       * @brief - The stream to the recording.
+       */
+      std::ifstream m_in;
+
+      /**
+       * @brief - The seed of the recorded session.
+       */
+      unsigned m_seed;
+
+      /**
+       * @brief - The number of frames replayed so far.
+       */
+      unsigned m_frames;
+  };
+
+  using InputPlayerShPtr = std::shared_ptr<InputPlayer>;
+
+}
+
+# include "InputLog.hxx"
+
+#endif    /* INPUT_LOG_HH */
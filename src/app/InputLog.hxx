@@ -0,0 +1,16 @@
+#ifndef    INPUT_LOG_HXX
+# define   INPUT_LOG_HXX
+
+# include "InputLog.hh"
+
+namespace pge {
+
+  inline
+  unsigned
+  InputPlayer::seed() const noexcept {
+    return m_seed;
+  }
+
+}
+
+#endif    /* INPUT_LOG_HXX */
@@ -1,5 +1,6 @@
 
 # include "PGEApp.hh"
+# include <cstdlib>
 
 namespace pge {
 
@@ -15,7 +16,24 @@ namespace pge {
     m_debugOn(false),
     m_uiOn(true),
 
+    // All layers need to be rendered in the first frame.
+    m_layers(static_cast<unsigned>(Layer::Debug) + 1u, LayerCache{true, {}}),
+
+    m_frameRate(desc.frameRate),
+    m_idleTimeout(desc.idleTimeout),
+    m_frameStart(),
+    m_timings(),
+    m_traceFile(desc.traceFile),
+
     m_controls(controls::newState()),
+    m_keyEvents(),
+    m_recorder(nullptr),
+    m_player(nullptr),
+    m_headless(desc.headless),
+    m_maxFrames(desc.frames),
+    m_frameCount(0u),
+    m_runStart(),
+    m_snapshotFile(desc.snapshotFile),
     m_first(true),
 
     m_fixedFrame(desc.fixedFrame),
@@ -33,6 +51,35 @@ namespace pge {
       );
     }
 
+    if (desc.trace) {
+      info("Recording trace to \"" + m_traceFile + "\"");
+      profiling::Tracer::start();
+    }
+
+    // The random number generator is seeded with the seed of
+    // the recording when replaying, so that the same tiles
+    // are spawned.
+    unsigned seed = desc.seed;
+    if (!desc.replayFile.empty()) {
+      m_player = std::make_shared<InputPlayer>(desc.replayFile);
+      seed = m_player->seed();
+    }
+    else if (!desc.recordFile.empty()) {
+      m_recorder = std::make_shared<InputRecorder>(desc.recordFile, seed);
+    }
+
+    std::srand(seed);
+
+    // Without a display there's nothing to pace the frames
+    // against: they are rendered as fast as possible.
+    if (m_headless) {
+      info("Rendering frames offscreen");
+      EnableHeadless();
+
+      m_frameRate = 0.0f;
+      m_idleTimeout = 0.0f;
+    }
+
     // Generate and construct the window.
     initialize(desc.dims, desc.pixRatio);
   }
@@ -69,14 +116,41 @@ namespace pge {
 
   bool
   PGEApp::OnUserUpdate(float fElapsedTime) {
+    m_frameStart = utils::now();
+    if (m_first) {
+      m_runStart = m_frameStart;
+    }
+    m_timings.begin();
+
+    // Images decoded in the background replace the
+    // placeholders displayed so far.
+    ImageCache& images = ImageCache::instance();
+    if (images.upload() > 0u) {
+      invalidate();
+    }
+
     // Handle inputs.
-    InputChanges ic = handleInputs();
+    InputChanges ic = handleInputs(fElapsedTime);
+    m_timings.mark(timings::HandleInputs);
 
     // Handle user inputs.
     onInputs(m_controls, *m_frame);
+    m_timings.mark(timings::OnInputs);
 
     // Handle game logic.
     bool quit = onFrame(fElapsedTime);
+    m_timings.mark(timings::OnFrame);
+
+    // Changes to the coordinate frame affect all layers.
+    if (ic.frameChanged) {
+      invalidate();
+    }
+    if (ic.debugLayerToggled) {
+      invalidate(Layer::Debug);
+    }
+    if (ic.uiLayerToggled) {
+      invalidate(Layer::UI);
+    }
 
     // Handle rendering: for each function
     // we will assign the draw target first
@@ -94,20 +168,28 @@ namespace pge {
     // the layer at least once to `activate`
     // them: otherwise the window usually
     // stays black.
-    SetDrawTarget(m_mDecalLayer);
-    drawDecal(res);
+    // Layers which did not change since the
+    // last frame are not rendered again.
+    bool rendered = render(Layer::DrawDecal, &PGEApp::drawDecal, res);
+    m_timings.mark(timings::DrawDecal);
 
-    SetDrawTarget(m_mLayer);
-    draw(res);
+    rendered = render(Layer::Draw, &PGEApp::draw, res) || rendered;
+    m_timings.mark(timings::Draw);
 
     if (hasUI()) {
-      SetDrawTarget(m_uiLayer);
-      drawUI(res);
+      rendered = render(Layer::UI, &PGEApp::drawUI, res) || rendered;
     }
-    if (!hasUI() && isFirstFrame()) {
+    if (!hasUI() && (ic.uiLayerToggled || isFirstFrame())) {
       SetDrawTarget(m_uiLayer);
       clearLayer();
     }
+    m_timings.mark(timings::DrawUI);
+
+    // The debug layer displays the timings of the frames
+    // so it is updated whenever something else is.
+    if (rendered || busy()) {
+      invalidate(Layer::Debug);
+    }
 
     // Draw the debug layer. As it is saved
     // in the layer `0` we need to clear it
@@ -122,13 +204,13 @@ namespace pge {
     // as the `0`-th layer would never be
     // updated.
     if (hasDebug()) {
-      SetDrawTarget(m_dLayer);
-      drawDebug(res);
+      rendered = render(Layer::Debug, &PGEApp::drawDebug, res) || rendered;
     }
     if (!hasDebug() && (ic.debugLayerToggled || isFirstFrame())) {
       SetDrawTarget(m_dLayer);
       clearLayer();
     }
+    m_timings.mark(timings::DrawDebug);
 
     // Restore the target.
     SetDrawTarget(base);
@@ -136,47 +218,162 @@ namespace pge {
     // Not the first frame anymore.
     m_first = false;
 
-    return !ic.quit && !quit;
+    m_timings.end();
+    pace(rendered || busy() || images.loading());
+
+    ++m_frameCount;
+    bool done = (m_maxFrames > 0u && m_frameCount >= m_maxFrames);
+
+    return !ic.quit && !quit && !done;
   }
 
-  PGEApp::InputChanges
-  PGEApp::handleInputs() {
-    InputChanges ic{false, false};
+  void
+  PGEApp::OnKeyStateChanged(olc::Key key, bool bPressed) {
+    // Only the keys tracked by the controls are queued.
+    controls::keys::Keys k;
+
+    switch (key) {
+      case olc::RIGHT:
+        k = controls::keys::Right;
+        break;
+      case olc::UP:
+        k = controls::keys::Up;
+        break;
+      case olc::LEFT:
+        k = controls::keys::Left;
+        break;
+      case olc::DOWN:
+        k = controls::keys::Down;
+        break;
+      case olc::SPACE:
+        k = controls::keys::Space;
+        break;
+      case olc::P:
+        k = controls::keys::P;
+        break;
+      case olc::N:
+        k = controls::keys::N;
+        break;
+      case olc::R:
+        k = controls::keys::R;
+        break;
+      case olc::S:
+        k = controls::keys::S;
+        break;
+      default:
+        return;
+    }
 
-    // Detect press on `Escape` key to shutdown the app.
-    olc::HWButton esc = GetKey(olc::ESCAPE);
-    if (esc.bReleased) {
-      ic.quit = true;
-      return ic;
+    m_keyEvents.push_back(controls::KeyEvent{k, bPressed, utils::now()});
+  }
+
+  bool
+  PGEApp::render(const Layer& layer, DrawFunction draw, const RenderDesc& res) {
+    uint32_t id = layerIndex(layer);
+    LayerCache& cache = m_layers[static_cast<unsigned>(layer)];
+    olc::LayerDesc& desc = GetLayers()[id];
+
+    // In case the layer did not change, we don't assign
+    // the draw target so that the engine doesn't upload
+    // its sprite again: we only need to submit the decals
+    // of the last rendering as they are discarded after
+    // each frame.
+    if (!cache.dirty) {
+      desc.vecDecalInstance.assign(cache.decals.begin(), cache.decals.end());
+      return false;
     }
 
-    if (!m_fixedFrame) {
-      // In case we're dragging the right mouse button we
-      // will update the world's position (panning). What
-      // we want is to remember the position at the moment
-      // of the click and then continuously move the world
-      // to match the current displacement.
-      if (GetMouse(1).bPressed) {
-        m_frame->beginTranslation(GetMousePos());
-      }
-      if (GetMouse(1).bHeld) {
-        m_frame->translate(GetMousePos());
-      }
+    SetDrawTarget(id);
+    (this->*draw)(res);
+
+    cache.decals.assign(desc.vecDecalInstance.begin(), desc.vecDecalInstance.end());
+    cache.dirty = false;
+
+    return true;
+  }
+
+  void
+  PGEApp::drawTimings(const olc::vi2d& pos) {
+    float budget = (m_frameRate > 0.0f ? 1000.0f / m_frameRate : 0.0f);
+    m_timings.render(this, pos, budget);
+  }
+
+  void
+  PGEApp::pace(bool active) {
+    // In case nothing changes there's no need to render
+    // frames until the user does something.
+    if (!active && m_idleTimeout > 0.0f) {
+      SetFrameWait(m_idleTimeout, true);
+      return;
+    }
+
+    if (m_frameRate <= 0.0f) {
+      return;
+    }
+
+    // Otherwise wait for the remaining part of the frame.
+    float elapsed = utils::diffInMs(m_frameStart, utils::now()) / 1000.0f;
+    float remaining = 1.0f / m_frameRate - elapsed;
+    if (remaining > 0.0f) {
+      SetFrameWait(remaining, false);
+    }
+  }
+
+  void
+  PGEApp::dumpTrace() {
+    profiling::Tracer::stop();
+
+    int count = profiling::Tracer::dump(m_traceFile);
+    if (count < 0) {
+      warn("Failed to save trace to \"" + m_traceFile + "\"");
+      return;
     }
 
+    info("Saved " + std::to_string(count) + " span(s) to \"" + m_traceFile + "\"");
+  }
+
+  void
+  PGEApp::saveSnapshot() {
+    olc::Sprite* frame = GetFrameSprite();
+    if (frame == nullptr) {
+      warn("No frame to save to \"" + m_snapshotFile + "\"");
+      return;
+    }
+
+    if (olc::Sprite::loader->SaveImageResource(frame, m_snapshotFile) != olc::rcode::OK) {
+      warn("Failed to save snapshot to \"" + m_snapshotFile + "\"");
+      return;
+    }
+
+    info(
+      "Saved " + std::to_string(frame->width) + "x" + std::to_string(frame->height) +
+      " snapshot to \"" + m_snapshotFile + "\""
+    );
+  }
+
+  void
+  PGEApp::reportTimings() {
+    float elapsed = utils::diffInMs(m_runStart, utils::now());
+    float fps = (elapsed > 0.0f ? 1000.0f * m_frameCount / elapsed : 0.0f);
+
+    info(
+      "Rendered " + std::to_string(m_frameCount) + " frame(s) in " +
+      std::to_string(elapsed) + "ms (" + std::to_string(fps) + " fps)"
+    );
+
+    info("Timings of the last " + std::to_string(m_timings.size()) + " frame(s) (p50, p99, max in ms):");
+    for (unsigned id = 0u ; id < timings::PhasesCount ; ++id) {
+      info(m_timings.summary(static_cast<timings::Phase>(id)));
+    }
+  }
+
+  void
+  PGEApp::readControls(int& scroll) {
     olc::vi2d mPos = GetMousePos();
     m_controls.mPosX = mPos.x;
     m_controls.mPosY = mPos.y;
 
-    if (!m_fixedFrame) {
-      int scroll = GetMouseWheel();
-      if (scroll > 0) {
-        m_frame->zoomIn(GetMousePos());
-      }
-      if (scroll < 0) {
-        m_frame->zoomOut(GetMousePos());
-      }
-    }
+    scroll = GetMouseWheel();
 
     // Handle inputs. Note that for keys apart for the
     // motion keys (or commonly used as so) we want to
@@ -228,6 +425,67 @@ namespace pge {
     m_controls.buttons[controls::mouse::Left] = analysis(GetMouse(0));
     m_controls.buttons[controls::mouse::Right] = analysis(GetMouse(1));
     m_controls.buttons[controls::mouse::Middle] = analysis(GetMouse(2));
+  }
+
+  PGEApp::InputChanges
+  PGEApp::handleInputs(float& elapsed) {
+    InputChanges ic{false, false, false, false};
+
+    // Detect press on `Escape` key to shutdown the app.
+    olc::HWButton esc = GetKey(olc::ESCAPE);
+    if (esc.bReleased) {
+      ic.quit = true;
+      return ic;
+    }
+
+    // Hand over the events of the keys received since
+    // the last frame: the queue keeps its capacity.
+    m_controls.events.swap(m_keyEvents);
+    m_keyEvents.clear();
+
+    int scroll = 0;
+
+    if (m_player != nullptr) {
+      // The replay ends with the recording.
+      if (!m_player->next(elapsed, scroll, m_controls)) {
+        ic.quit = true;
+        return ic;
+      }
+    }
+    else {
+      readControls(scroll);
+    }
+
+    if (m_recorder != nullptr) {
+      m_recorder->record(elapsed, scroll, m_controls);
+    }
+
+    if (!m_fixedFrame) {
+      // In case we're dragging the right mouse button we
+      // will update the world's position (panning). What
+      // we want is to remember the position at the moment
+      // of the click and then continuously move the world
+      // to match the current displacement.
+      olc::vi2d mPos(m_controls.mPosX, m_controls.mPosY);
+      controls::ButtonState rb = m_controls.buttons[controls::mouse::Right];
+
+      if (rb == controls::ButtonState::Pressed) {
+        m_frame->beginTranslation(mPos);
+      }
+      if (rb == controls::ButtonState::Pressed || rb == controls::ButtonState::Held) {
+        m_frame->translate(mPos);
+        ic.frameChanged = true;
+      }
+
+      if (scroll > 0) {
+        m_frame->zoomIn(mPos);
+        ic.frameChanged = true;
+      }
+      if (scroll < 0) {
+        m_frame->zoomOut(mPos);
+        ic.frameChanged = true;
+      }
+    }
 
     // De/activate the debug mode if needed and
     // handle general simulation control options.
@@ -237,6 +495,19 @@ namespace pge {
     }
     if (GetKey(olc::U).bReleased) {
       m_uiOn = !m_uiOn;
+      ic.uiLayerToggled = true;
+    }
+
+    // Start recording a trace or save the one which is
+    // being recorded.
+    if (GetKey(olc::T).bReleased) {
+      if (profiling::Tracer::recording()) {
+        dumpTrace();
+      }
+      else {
+        info("Recording trace to \"" + m_traceFile + "\"");
+        profiling::Tracer::start();
+      }
     }
 
     return ic;
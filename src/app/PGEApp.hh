@@ -1,11 +1,17 @@
 #ifndef    PGE_APP_HH
 # define   PGE_APP_HH
 
+# include <vector>
 # include <core_utils/CoreObject.hh>
+# include <core_utils/TimeUtils.hh>
 # include "olcEngine.hh"
 # include "AppDesc.hh"
 # include "CoordinateFrame.hh"
 # include "Controls.hh"
+# include "FrameTimings.hh"
+# include "ImageCache.hh"
+# include "InputLog.hh"
+# include "Tracer.hh"
 
 namespace pge {
 
@@ -52,6 +58,16 @@ namespace pge {
       bool
       OnUserDestroy() override;
 
+      /**
+       * @brief - Override of the function called for each change
+       *          of state of a key: changes of the tracked keys
+       *          are queued until the next frame.
+       * @param key - the key which changed.
+       * @param bPressed - whether the key was pressed.
+       */
+      void
+      OnKeyStateChanged(olc::Key key, bool bPressed) override;
+
     protected:
 
       /// @brief - Convenience define refering to a drawing layer.
@@ -119,6 +135,16 @@ namespace pge {
       bool
       hasUI() const noexcept;
 
+      /**
+       * @brief - Whether the inputs are recorded or replayed: the
+       *          logic of the app should then only depend on them
+       *          and on the duration of the frames so that replays
+       *          reproduce the recorded session.
+       * @return - `true` if the session is recorded or replayed.
+       */
+      bool
+      deterministic() const noexcept;
+
       /**
        * @brief - Used to assign a certain tint to the layer
        *          defined by the input descriptor.
@@ -129,6 +155,37 @@ namespace pge {
       void
       setLayerTint(const Layer& layer, const olc::Pixel& tint);
 
+      /**
+       * @brief - Request the input layer to be rendered again in
+       *          the next frame. Layers are only rendered when they
+       *          are invalidated: otherwise the content produced in
+       *          the last rendering is displayed again. Inheriting
+       *          classes should call this method whenever the data
+       *          displayed in a layer changes.
+       *          Note that all layers are invalidated when the
+       *          coordinate frame changes.
+       * @param layer - the layer to render again.
+       */
+      void
+      invalidate(const Layer& layer) noexcept;
+
+      /**
+       * @brief - Similar to the above method but invalidates all
+       *          the layers.
+       */
+      void
+      invalidate() noexcept;
+
+      /**
+       * @brief - Draw the statistics of the duration of the phases
+       *          of the last frames along with a graph of the time
+       *          spent in each frame. Should be called when drawing
+       *          the debug layer.
+       * @param pos - the top left corner of the overlay in pixels.
+       */
+      void
+      drawTimings(const olc::vi2d& pos);
+
       /**
        * @brief - Another interface method allowing to clear
        *          a rendering layer when it's disabled. This
@@ -139,6 +196,20 @@ namespace pge {
       virtual void
       clearLayer();
 
+      /**
+       * @brief - Interface method allowing inheriting classes to
+       *          indicate that they need to be updated even though
+       *          no layer changed, for example to poll the results
+       *          of a background computation or to run a timer.
+       *          When no layer changed and the app is not busy the
+       *          next frame only starts when an event is received.
+       *          The default implementation returns `false`.
+       * @return - `true` if the next frame should not wait for an
+       *           event.
+       */
+      virtual bool
+      busy() const noexcept;
+
       /**
        * @brief - Interface method allowing to load the data
        *          needed for the data displayed by this app.
@@ -263,8 +334,29 @@ namespace pge {
 
         // Whether the debug layer should be visible.
         bool debugLayerToggled;
+
+        // Whether the UI layer should be visible.
+        bool uiLayerToggled;
+
+        // Whether the coordinate frame was panned or zoomed.
+        bool frameChanged;
+      };
+
+      /// @brief - The content produced by the last rendering of a
+      /// layer, allowing to display it again without rendering it.
+      struct LayerCache {
+        // Whether the layer should be rendered again.
+        bool dirty;
+
+        // The decals submitted during the last rendering: the
+        // engine discards them after each frame.
+        std::vector<olc::DecalInstance> decals;
       };
 
+      /// @brief - Convenience define for one of the rendering
+      /// functions of a layer.
+      using DrawFunction = void (PGEApp::*)(const RenderDesc&);
+
       /**
        * @brief - Performs the initialization of the engine to make
        *          it suits our needs.
@@ -281,13 +373,81 @@ namespace pge {
       /**
        * @brief - Used to perform the necessary update based on
        *          the controls that the user might have used in
-       *          the game.
+       *          the game. When a recording is replayed the
+       *          controls come from the recording instead.
+       * @param elapsed - the duration of the frame, replaced by
+       *                  the recorded one when replaying.
        * @return - a state describing the changes processed in
        *           this method. It includes any exit request of
        *           the user and changes to the UI.
        */
       InputChanges
-      handleInputs();
+      handleInputs(float& elapsed);
+
+      /**
+       * @brief - Read the state of the controls from the devices.
+       * @param scroll - output argument receiving the scroll of
+       *                 the mouse wheel.
+       */
+      void
+      readControls(int& scroll);
+
+      /**
+       * @brief - Returns the index of the engine's layer for the
+       *          input layer.
+       * @param layer - the layer to convert.
+       * @return - the index of the layer in the engine.
+       */
+      uint32_t
+      layerIndex(const Layer& layer) const noexcept;
+
+      /**
+       * @brief - Render the input layer if it is invalidated, or
+       *          submit again the content of its last rendering
+       *          otherwise. In the latter case the sprite of the
+       *          layer is not modified so the engine does not have
+       *          to upload it again.
+       * @param layer - the layer to render.
+       * @param draw - the function rendering the layer.
+       * @param res - the resources to help the drawing.
+       * @return - `true` if the layer was rendered.
+       */
+      bool
+      render(const Layer& layer, DrawFunction draw, const RenderDesc& res);
+
+      /**
+       * @brief - Configure the wait of the engine before the next
+       *          frame. If something changed the frame rate is
+       *          capped to the configured value, otherwise the
+       *          engine waits for the next event.
+       * @param active - `true` if something changed during this
+       *                 frame.
+       */
+      void
+      pace(bool active);
+
+      /**
+       * @brief - Stop recording the trace of the execution and save
+       *          it to the trace file.
+       */
+      void
+      dumpTrace();
+
+      /**
+       * @brief - Save the last frame composed by the renderer to
+       *          the snapshot file. Only available when the app is
+       *          headless.
+       */
+      void
+      saveSnapshot();
+
+      /**
+       * @brief - Log the number of frames rendered since the start
+       *          of the app and the duration of the phases of the
+       *          last ones.
+       */
+      void
+      reportTimings();
 
     private:
 
@@ -340,6 +500,41 @@ namespace pge {
        */
       bool m_uiOn;
 
+      /**
+       * @brief - The content of each layer as produced by its last
+       *          rendering, indexed by the `Layer` enumeration.
+       */
+      std::vector<LayerCache> m_layers;
+
+      /**
+       * @brief - The maximum number of frames per second while the
+       *          content of the app changes, `0` if unlimited.
+       */
+      float m_frameRate;
+
+      /**
+       * @brief - The maximum wait in seconds for an event when the
+       *          content of the app doesn't change, `0` to render
+       *          frames continuously.
+       */
+      float m_idleTimeout;
+
+      /**
+       * @brief - The time at which the current frame started.
+       */
+      utils::TimeStamp m_frameStart;
+
+      /**
+       * @brief - The duration of the phases of the last frames.
+       */
+      FrameTimings m_timings;
+
+      /**
+       * @brief - The file where the trace of the execution is
+       *          saved.
+       */
+      std::string m_traceFile;
+
       /**
        * @brief - A map to keep track of the state of the controls
        *          to be transmitted to the world's entities for
@@ -347,6 +542,52 @@ namespace pge {
        */
       controls::State m_controls;
 
+      /**
+       * @brief - The events of the keys received since the last
+       *          frame, in the order of their reception.
+       */
+      std::vector<controls::KeyEvent> m_keyEvents;
+
+      /**
+       * @brief - Records the inputs of each frame, `null` if they
+       *          are not recorded.
+       */
+      InputRecorderShPtr m_recorder;
+
+      /**
+       * @brief - Replays recorded inputs instead of reading them
+       *          from the devices, `null` if nothing is replayed.
+       */
+      InputPlayerShPtr m_player;
+
+      /**
+       * @brief - Whether the frames are rendered in memory rather
+       *          than in a window.
+       */
+      bool m_headless;
+
+      /**
+       * @brief - The number of frames after which the app exits,
+       *          `0` if there's no limit.
+       */
+      unsigned m_maxFrames;
+
+      /**
+       * @brief - The number of frames rendered so far.
+       */
+      unsigned m_frameCount;
+
+      /**
+       * @brief - The time at which the first frame started.
+       */
+      utils::TimeStamp m_runStart;
+
+      /**
+       * @brief - The file where the last frame is saved when the
+       *          app exits, empty if it is not saved.
+       */
+      std::string m_snapshotFile;
+
       /**
        * @brief - Boolean allowing to display logs only on the
        *          first frame. Or do any other process a single
@@ -20,9 +20,26 @@ namespace pge {
   inline
   bool
   PGEApp::OnUserDestroy() {
+    if (profiling::Tracer::recording()) {
+      dumpTrace();
+    }
+
+    // The last frame was composed once the update returned
+    // so it is still available.
+    if (m_headless) {
+      if (!m_snapshotFile.empty()) {
+        saveSnapshot();
+      }
+      reportTimings();
+    }
+
     cleanResources();
     cleanMenuResources();
 
+    // Images still referenced need to be released while the
+    // rendering context is valid.
+    ImageCache::instance().clear();
+
     return true;
   }
 
@@ -44,26 +61,38 @@ namespace pge {
     return m_uiOn;
   }
 
+  inline
+  bool
+  PGEApp::deterministic() const noexcept {
+    return m_player != nullptr || m_recorder != nullptr;
+  }
+
   inline
   void
   PGEApp::setLayerTint(const Layer& layer, const olc::Pixel& tint) {
-    switch (layer) {
-      case Layer::Draw:
-        SetLayerTint(m_mLayer, tint);
-        break;
-      case Layer::DrawDecal:
-        SetLayerTint(m_mDecalLayer, tint);
-        break;
-      case Layer::UI:
-        SetLayerTint(m_uiLayer, tint);
-        break;
-      case Layer::Debug:
-      default:
-        SetLayerTint(m_dLayer, tint);
-        break;
+    SetLayerTint(layerIndex(layer), tint);
+  }
+
+  inline
+  void
+  PGEApp::invalidate(const Layer& layer) noexcept {
+    m_layers[static_cast<unsigned>(layer)].dirty = true;
+  }
+
+  inline
+  void
+  PGEApp::invalidate() noexcept {
+    for (unsigned id = 0u ; id < m_layers.size() ; ++id) {
+      m_layers[id].dirty = true;
     }
   }
 
+  inline
+  bool
+  PGEApp::busy() const noexcept {
+    return false;
+  }
+
   inline
   void
   PGEApp::clearLayer() {
@@ -73,6 +102,22 @@ namespace pge {
     SetPixelMode(olc::Pixel::NORMAL);
   }
 
+  inline
+  uint32_t
+  PGEApp::layerIndex(const Layer& layer) const noexcept {
+    switch (layer) {
+      case Layer::Draw:
+        return m_mLayer;
+      case Layer::DrawDecal:
+        return m_mDecalLayer;
+      case Layer::UI:
+        return m_uiLayer;
+      case Layer::Debug:
+      default:
+        return m_dLayer;
+    }
+  }
+
   inline
   void
   PGEApp::initialize(const olc::vi2d& dims, const olc::vi2d& pixRatio) {
@@ -0,0 +1,53 @@
+
+# include "RectPacker.hh"
+# include <algorithm>
+
+namespace pge {
+
+  RectPacker::RectPacker(const olc::vi2d& size):
+    m_size(size),
+    m_shelves(),
+    m_extent()
+  {}
+
+  bool
+  RectPacker::insert(const olc::vi2d& size, olc::vi2d& pos) {
+    if (size.x <= 0 || size.y <= 0 || size.x > m_size.x || size.y > m_size.y) {
+      return false;
+    }
+
+    // Find the shelf wasting the least height.
+    Shelf* best = nullptr;
+
+    for (unsigned id = 0u ; id < m_shelves.size() ; ++id) {
+      Shelf& s = m_shelves[id];
+      if (s.height < size.y || s.x + size.x > m_size.x) {
+        continue;
+      }
+
+      if (best == nullptr || s.height < best->height) {
+        best = &s;
+      }
+    }
+
+    // Open a new shelf below the last one if needed.
+    if (best == nullptr) {
+      int y = (m_shelves.empty() ? 0 : m_shelves.back().y + m_shelves.back().height);
+      if (y + size.y > m_size.y) {
+        return false;
+      }
+
+      m_shelves.push_back(Shelf{y, size.y, 0});
+      best = &m_shelves.back();
+    }
+
+    pos = olc::vi2d(best->x, best->y);
+    best->x += size.x;
+
+    m_extent.x = std::max(m_extent.x, pos.x + size.x);
+    m_extent.y = std::max(m_extent.y, pos.y + size.y);
+
+    return true;
+  }
+
+}
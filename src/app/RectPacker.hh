@@ -0,0 +1,79 @@
+#ifndef    RECT_PACKER_HH
+# define   RECT_PACKER_HH
+
+# include <vector>
+# include "olcEngine.hh"
+
+namespace pge {
+
+  /// @brief - Packs rectangles in an area of fixed dimensions using
+  /// shelves: rectangles are placed side by side on horizontal rows
+  /// as high as the first rectangle placed on them. Rectangles are
+  /// placed on the shelf wasting the least height, and a new shelf
+  /// is opened when none can accomodate the rectangle.
+  /// The packing is best when rectangles are inserted in order of
+  /// decreasing height.
+  class RectPacker {
+    public:
+
+      /**
+       * @brief - Create a new empty packer for the input area.
+       * @param size - the dimensions of the area to fill.
+       */
+      explicit
+      RectPacker(const olc::vi2d& size);
+
+      /**
+       * @brief - Try to place a rectangle in the area.
+       * @param size - the dimensions of the rectangle.
+       * @param pos - output argument receiving the position of the
+       *              top left corner of the rectangle.
+       * @return - `false` if there's not enough room left for the
+       *           rectangle, in which case `pos` is not modified.
+       */
+      bool
+      insert(const olc::vi2d& size, olc::vi2d& pos);
+
+      /**
+       * @brief - The dimensions of the smallest area containing all
+       *          the rectangles placed so far.
+       * @return - the extent of the placed rectangles.
+       */
+      olc::vi2d
+      extent() const noexcept;
+
+    private:
+
+      /// @brief - A row of rectangles.
+      struct Shelf {
+        // The ordinate of the top of the shelf.
+        int y;
+
+        // The height of the shelf.
+        int height;
+
+        // The abscissa where the next rectangle is placed.
+        int x;
+      };
+
+      /**
+       * @brief - The dimensions of the area.
+       */
+      olc::vi2d m_size;
+
+      /**
+       * @brief - The shelves opened so far, from top to bottom.
+       */
+      std::vector<Shelf> m_shelves;
+
+      /**
+       * @brief - The extent of the placed rectangles.
+       */
+      olc::vi2d m_extent;
+  };
+
+}
+
+# include "RectPacker.hxx"
+
+#endif    /* RECT_PACKER_HH */
@@ -0,0 +1,16 @@
+#ifndef    RECT_PACKER_HXX
+# define   RECT_PACKER_HXX
+
+# include "RectPacker.hh"
+
+namespace pge {
+
+  inline
+  olc::vi2d
+  RectPacker::extent() const noexcept {
+    return m_extent;
+  }
+
+}
+
+#endif    /* RECT_PACKER_HXX */
@@ -1,45 +1,78 @@
 
 # include "TexturePack.hh"
+# include <algorithm>
+# include <cstring>
+# include <limits>
+# include "ColorUtils.hh"
+# include "RectPacker.hh"
+# include "Tracer.hh"
+
+/// @brief - The dimensions of a page of the atlas in pixels. Packs
+/// larger than this are not part of the atlas.
+# define ATLAS_PAGE_SIZE 2048
+
+/// @brief - The space left between packs in the atlas so that
+/// filtering doesn't pick pixels from a neighbouring pack.
+# define ATLAS_PADDING 1
+
+/// @brief - The page of packs which are not part of the atlas.
+# define NO_ATLAS_PAGE std::numeric_limits<unsigned>::max()
 
 namespace pge {
 
   TexturePack::TexturePack():
     utils::CoreObject("pack"),
 
-    m_packs()
+    m_packs(),
+    m_pages(),
+    m_packed(0u),
+    m_settled(0u),
+    m_ids()
   {
     setService("textures");
   }
 
   TexturePack::~TexturePack() {
-    for (unsigned id = 0 ; id < m_packs.size() ; ++id) {
-      if (m_packs[id].res != nullptr) {
-        delete m_packs[id].res;
-      }
-    }
-
+    releaseAtlas();
     m_packs.clear();
   }
 
   unsigned
   TexturePack::registerPack(const sprites::Pack& pack) {
-    // Load the file as a sprite and then convert it
-    // to a faster `Decal` resource.
-    olc::Sprite* spr = new olc::Sprite(pack.file);
-    if (spr == nullptr) {
+    // Load the file as a `Decal` resource: in case it
+    // was already loaded it is reused from the cache.
+    ImageShPtr img = ImageCache::instance().load(pack.file);
+    if (img == nullptr) {
       error(
         "Failed to load texture pack \"" + pack.file + "\"",
         "Loading returned null"
       );
     }
 
+    return registerImage(pack, img);
+  }
+
+  unsigned
+  TexturePack::registerPackAsync(const sprites::Pack& pack) {
+    // The image is uploaded by the application once it
+    // has been decoded.
+    return registerImage(pack, ImageCache::instance().loadAsync(pack.file));
+  }
+
+  unsigned
+  TexturePack::registerImage(const sprites::Pack& pack, ImageShPtr img) {
     // Build the internal structure, register it and
     // return the corresponding identifier.
     Pack p;
     p.sSize = pack.sSize;
     p.layout = pack.layout;
 
-    p.res = new olc::Decal(spr);
+    p.res = img;
+
+    // The pack is drawn from its own texture until the
+    // atlas is built again.
+    p.page = NO_ATLAS_PAGE;
+    p.offset = olc::vi2d();
 
     unsigned id = m_packs.size();
     m_packs.push_back(p);
@@ -47,6 +80,121 @@ namespace pge {
     return id;
   }
 
+  bool
+  TexturePack::update() {
+    // Nothing can change until a pack is registered once
+    // the images of all the packs are available.
+    if (m_settled == m_packs.size()) {
+      return false;
+    }
+
+    // Only loaded packs can be part of the atlas.
+    m_ids.clear();
+    m_settled = 0u;
+
+    for (unsigned id = 0u ; id < m_packs.size() ; ++id) {
+      const Image& img = *m_packs[id].res;
+
+      if (img.ready()) {
+        ++m_settled;
+      }
+      if (img.sprite() != nullptr) {
+        m_ids.push_back(id);
+      }
+    }
+
+    if (m_ids.size() == m_packed) {
+      return false;
+    }
+
+    profiling::Span span("build atlas", "resources");
+
+    releaseAtlas();
+    m_packed = m_ids.size();
+
+    // Place the highest packs first as this is what works
+    // best for the packer.
+    std::sort(
+      m_ids.begin(),
+      m_ids.end(),
+      [this](unsigned lhs, unsigned rhs) {
+        return m_packs[lhs].res->sprite()->height > m_packs[rhs].res->sprite()->height;
+      }
+    );
+
+    std::vector<RectPacker> packers;
+
+    for (unsigned id = 0u ; id < m_ids.size() ; ++id) {
+      Pack& p = m_packs[m_ids[id]];
+      olc::Sprite* spr = p.res->sprite();
+      olc::vi2d sz(spr->width + ATLAS_PADDING, spr->height + ATLAS_PADDING);
+
+      unsigned page = 0u;
+      while (page < packers.size() && !packers[page].insert(sz, p.offset)) {
+        ++page;
+      }
+
+      if (page == packers.size()) {
+        packers.push_back(RectPacker(olc::vi2d(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE)));
+
+        // Too large packs keep their own texture: the position
+        // is only modified in case of success.
+        if (!packers.back().insert(sz, p.offset)) {
+          packers.pop_back();
+          continue;
+        }
+      }
+
+      p.page = page;
+    }
+
+    // Copy the packs to their page: pages are only as large
+    // as needed to hold their packs.
+    for (unsigned page = 0u ; page < packers.size() ; ++page) {
+      olc::vi2d ext = packers[page].extent();
+
+      olc::Sprite* spr = new olc::Sprite(ext.x, ext.y);
+      std::fill(spr->pColData, spr->pColData + ext.x * ext.y, olc::BLANK);
+
+      for (unsigned id = 0u ; id < m_ids.size() ; ++id) {
+        const Pack& p = m_packs[m_ids[id]];
+        if (p.page != page) {
+          continue;
+        }
+
+        const olc::Sprite* src = p.res->sprite();
+        for (int y = 0 ; y < src->height ; ++y) {
+          std::memcpy(
+            spr->pColData + (p.offset.y + y) * ext.x + p.offset.x,
+            src->pColData + y * src->width,
+            src->width * sizeof(olc::Pixel)
+          );
+        }
+      }
+
+      m_pages.push_back(std::make_shared<Image>(spr));
+    }
+
+    verbose(
+      "Built atlas with " + std::to_string(m_packed) + " pack(s) in " +
+      std::to_string(m_pages.size()) + " page(s)"
+    );
+
+    return true;
+  }
+
+  void
+  TexturePack::releaseAtlas() noexcept {
+    // The pages are not shared so we can release them.
+    m_pages.clear();
+    m_packed = 0u;
+
+    for (unsigned id = 0u ; id < m_packs.size() ; ++id) {
+      m_packs[id].page = NO_ATLAS_PAGE;
+      m_packs[id].offset = olc::vi2d();
+    }
+  }
+
   void
   TexturePack::draw(olc::PixelGameEngine* pge,
                     const sprites::Sprite& s,
@@ -61,8 +209,18 @@ namespace pge {
 
     const Pack& tp = m_packs[s.pack];
 
+    // Use the atlas page holding the pack if any. The image
+    // might not be loaded yet or released already: draw a
+    // placeholder in the meantime.
+    olc::Decal* res = (tp.page < m_pages.size() ? m_pages[tp.page]->decal() : tp.res->decal());
+    if (res == nullptr) {
+      olc::vf2d sz(tp.sSize.x * scale.x, tp.sSize.y * scale.y);
+      pge->FillRectDecal(p, sz, olc::Pixel(128, 128, 128, alpha::SemiOpaque));
+      return;
+    }
+
     olc::vi2d sCoords = spriteCoords(tp, s.sprite, s.id);
-    pge->DrawPartialDecal(p, tp.res, sCoords, tp.sSize, scale, s.tint);
+    pge->DrawPartialDecal(p, res, sCoords, tp.sSize, scale, s.tint);
   }
 
 }
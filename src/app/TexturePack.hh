@@ -4,6 +4,7 @@
 # include <memory>
 # include <core_utils/CoreObject.hh>
 # include "olcEngine.hh"
+# include "ImageCache.hh"
 
 namespace pge {
   namespace sprites {
@@ -63,7 +64,8 @@ namespace pge {
 
       /**
        * @brief - Detroys the texture pack and release the sprites
-       *          and resources attached to it.
+       *          attached to it. The images themselves are owned
+       *          by the `ImageCache`.
        */
       ~TexturePack();
 
@@ -79,11 +81,49 @@ namespace pge {
       unsigned
       registerPack(const sprites::Pack& pack);
 
+      /**
+       * @brief - Similar to `registerPack` but the file of the
+       *          pack is decoded in the background and uploaded
+       *          during a later frame. Until then, sprites of the
+       *          pack are drawn as placeholders. Failure to load
+       *          the pack is reported with a warning.
+       * @param pack - the pack to load.
+       * @return - an identifier allowing to reference this
+       *           pack for later use.
+       */
+      unsigned
+      registerPackAsync(const sprites::Pack& pack);
+
+      /**
+       * @brief - Whether the input pack is ready to be drawn.
+       * @param pack - the identifier of the pack.
+       * @return - `true` if the pack is loaded.
+       */
+      bool
+      ready(unsigned pack) const noexcept;
+
+      /**
+       * @brief - Gather the sprites of all the packs loaded so far
+       *          in as few textures as possible, so that drawing
+       *          sprites from different packs does not need to
+       *          switch textures. Nothing happens if no pack was
+       *          loaded since the last call, so it can be called
+       *          at each frame to pick up packs loaded in the
+       *          background: once all the packs are loaded it
+       *          returns right away. The packs placed in the
+       *          atlas never create a texture of their own.
+       *          Should be called from the rendering thread.
+       * @return - `true` if the atlas was rebuilt.
+       */
+      bool
+      update();
+
       /**
        * @brief - Used to perform the drawing of the sprite as
        *          defined by the input argument using the engine.
        *          The sprite will be associated internally with
-       *          the corresponding visual.
+       *          the corresponding visual. In case the pack is
+       *          not loaded yet a placeholder is drawn instead.
        * @param pge - the engine to use to perform the rendering.
        * @param s - the sprite to draw.
        * @param p - the position where the sprite will be drawn.
@@ -130,8 +170,18 @@ namespace pge {
 
         // The `res` defines the raw data to the whole sprites
         // registered for this pack. Individual parts describe
-        // each sprite.
-        olc::Decal* res;
+        // each sprite. The image is shared with any other user
+        // of the same file.
+        ImageShPtr res;
+
+        // The `page` defines the index of the atlas page holding
+        // the sprites of the pack. Packs which are not part of
+        // the atlas are drawn from `res`.
+        unsigned page;
+
+        // The `offset` defines the position of the pack in its
+        // atlas page.
+        olc::vi2d offset;
       };
 
       /**
@@ -160,6 +210,23 @@ namespace pge {
                    const olc::vi2d& coord,
                    int id = 0) const;
 
+      /**
+       * @brief - Register a pack using the input image for its
+       *          sprites.
+       * @param pack - the description of the pack.
+       * @param img - the image of the pack.
+       * @return - the identifier of the pack.
+       */
+      unsigned
+      registerImage(const sprites::Pack& pack, ImageShPtr img);
+
+      /**
+       * @brief - Release the pages of the atlas: all packs are then
+       *          drawn from their own texture.
+       */
+      void
+      releaseAtlas() noexcept;
+
     private:
 
       /**
@@ -169,6 +236,32 @@ namespace pge {
        *          the pack in this vector.
        */
       std::vector<Pack> m_packs;
+
+      /**
+       * @brief - The pages of the atlas gathering the sprites of
+       *          the packs.
+       */
+      std::vector<ImageShPtr> m_pages;
+
+      /**
+       * @brief - The number of packs which were loaded when the
+       *          atlas was last built.
+       */
+      unsigned m_packed;
+
+      /**
+       * @brief - The number of packs whose image was available,
+       *          i.e. decoded or failed to load, during the last
+       *          update. Once it reaches the number of packs the
+       *          atlas can't change anymore.
+       */
+      unsigned m_settled;
+
+      /**
+       * @brief - The identifiers of the packs to place in the
+       *          atlas, kept to avoid allocations.
+       */
+      std::vector<unsigned> m_ids;
   };
 
   using TexturePackShPtr = std::shared_ptr<TexturePack>;
@@ -16,6 +16,12 @@ namespace pge {
     draw(pge, s, p, olc::vf2d(scale, scale));
   }
 
+  inline
+  bool
+  TexturePack::ready(unsigned pack) const noexcept {
+    return pack < m_packs.size() && m_packs[pack].res->sprite() != nullptr;
+  }
+
   inline
   olc::vi2d
   TexturePack::spriteCoords(const Pack& pack,
@@ -27,7 +33,8 @@ namespace pge {
     // Go back to 2D coordinates using the layout on
     // the linearized ID and the size of the sprite
     // to obtain a pixels position.
-    return olc::vi2d(
+    // The pack may be part of an atlas page.
+    return pack.offset + olc::vi2d(
       (lID % pack.layout.x) * pack.sSize.x,
       (lID / pack.layout.x) * pack.sSize.y
     );
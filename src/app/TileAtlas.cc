@@ -0,0 +1,204 @@
+
+# include "TileAtlas.hh"
+# include <cmath>
+
+/// @brief - The number of tiles on each row of the atlas.
+# define TILES_PER_ROW 8u
+
+/// @brief - The preferred scale of the text of the tiles. It
+/// is reduced if the text doesn't fit in the tile.
+# define TEXT_SCALE 2u
+
+/// @brief - The largest size of a tile in the atlas: larger
+/// tiles are drawn directly as the atlas would take a lot of
+/// memory for little benefit.
+# define MAX_TILE_SIZE 128u
+
+/// @brief - The delay in seconds during which the size of the
+/// tiles should not change before the atlas is rebuilt. This
+/// avoids rebuilding it at each frame while zooming.
+# define SETTLE_DELAY 0.25f
+
+namespace pge {
+
+  TileAtlas::TileAtlas(unsigned count,
+                       const tiles::ColorProvider& background,
+                       const tiles::ColorProvider& text):
+    utils::CoreObject("atlas"),
+
+    m_count(count),
+
+    m_background(background),
+    m_text(text),
+
+    m_size(0u),
+    m_requested(0u),
+    m_idle(0.0f),
+    m_sprite(nullptr),
+    m_decal(nullptr)
+  {
+    setService("textures");
+  }
+
+  TileAtlas::~TileAtlas() {
+    release();
+  }
+
+  void
+  TileAtlas::update(olc::PixelGameEngine* pge, unsigned size) {
+    if (size == m_requested || size == 0u) {
+      return;
+    }
+
+    m_requested = size;
+    m_idle = 0.0f;
+
+    // The first atlas is built right away: there's no
+    // zoom going on yet.
+    if (m_size == 0u && pending()) {
+      m_size = m_requested;
+      build(pge);
+    }
+  }
+
+  bool
+  TileAtlas::settle(olc::PixelGameEngine* pge, float tDelta) {
+    if (!pending()) {
+      return false;
+    }
+
+    m_idle += tDelta;
+    if (m_idle < SETTLE_DELAY) {
+      return false;
+    }
+
+    m_size = m_requested;
+    build(pge);
+
+    return true;
+  }
+
+  bool
+  TileAtlas::pending() const noexcept {
+    return m_requested != m_size && m_requested <= MAX_TILE_SIZE;
+  }
+
+  bool
+  TileAtlas::draw(olc::PixelGameEngine* pge,
+                  unsigned value,
+                  const olc::vf2d& pos,
+                  const olc::vf2d& size) const
+  {
+    unsigned id = indexOf(value);
+    if (id >= m_count) {
+      return false;
+    }
+
+    // Use the atlas only if it matches the requested size:
+    // otherwise draw the tile directly.
+    if (m_decal != nullptr && m_size == m_requested) {
+      olc::vf2d src((id % TILES_PER_ROW) * m_size, (id / TILES_PER_ROW) * m_size);
+      pge->DrawPartialDecal(pos, size, m_decal, src, olc::vf2d(m_size, m_size));
+
+      return true;
+    }
+
+    std::string str = std::to_string(value);
+    unsigned scale;
+    olc::vi2d offset = layout(pge, str, static_cast<unsigned>(std::round(size.x)), scale);
+
+    pge->FillRectDecal(pos, size, m_background(value));
+    pge->DrawStringDecal(pos + offset, str, m_text(value), olc::vf2d(scale, scale));
+
+    return true;
+  }
+
+  void
+  TileAtlas::build(olc::PixelGameEngine* pge) {
+    release();
+
+    unsigned rows = (m_count + TILES_PER_ROW - 1u) / TILES_PER_ROW;
+    m_sprite = new olc::Sprite(TILES_PER_ROW * m_size, rows * m_size);
+
+    // Render each tile in the sprite: we need to restore
+    // the draw target afterwards as this may be called
+    // while rendering a layer.
+    olc::Sprite* target = pge->GetDrawTarget();
+    olc::Pixel::Mode mode = pge->GetPixelMode();
+
+    pge->SetDrawTarget(m_sprite);
+    pge->SetPixelMode(olc::Pixel::NORMAL);
+    pge->Clear(olc::BLANK);
+
+    for (unsigned id = 0u ; id < m_count ; ++id) {
+      unsigned value = 1u << (id + 1u);
+      std::string str = std::to_string(value);
+
+      olc::vi2d p((id % TILES_PER_ROW) * m_size, (id / TILES_PER_ROW) * m_size);
+      pge->FillRect(p, olc::vi2d(m_size, m_size), m_background(value));
+
+      unsigned scale;
+      olc::vi2d offset = layout(pge, str, m_size, scale);
+      pge->DrawString(p + offset, str, m_text(value), scale);
+    }
+
+    pge->SetPixelMode(mode);
+    pge->SetDrawTarget(target);
+
+    m_decal = new olc::Decal(m_sprite);
+
+    verbose("Built atlas with " + std::to_string(m_count) + " tile(s) of " + std::to_string(m_size) + " pixel(s)");
+  }
+
+  olc::vi2d
+  TileAtlas::layout(olc::PixelGameEngine* pge,
+                    const std::string& str,
+                    unsigned size,
+                    unsigned& scale) const
+  {
+    // Use a smaller text if it doesn't fit.
+    olc::vi2d sz = pge->GetTextSize(str);
+    scale = TEXT_SCALE;
+    while (scale > 1u && sz.x * scale > size) {
+      --scale;
+    }
+
+    // The text may still be wider than the tile at the
+    // smallest scale: it is then aligned on the left of
+    // the tile and the overflow is either covered by the
+    // next tile, which is drawn afterwards, or clipped by
+    // the edge of the atlas.
+    int w = static_cast<int>(size);
+    int s = static_cast<int>(scale);
+    return olc::vi2d(
+      std::max((w - sz.x * s) / 2, 0),
+      std::max((w - sz.y * s) / 2, 0)
+    );
+  }
+
+  void
+  TileAtlas::release() noexcept {
+    if (m_decal != nullptr) {
+      delete m_decal;
+    }
+    if (m_sprite != nullptr) {
+      delete m_sprite;
+    }
+
+    m_decal = nullptr;
+    m_sprite = nullptr;
+  }
+
+  unsigned
+  TileAtlas::indexOf(unsigned value) const noexcept {
+    // Tiles start at `2` which has an index of `0`.
+    unsigned e = 0u;
+    while (value > 1u) {
+      value >>= 1u;
+      ++e;
+    }
+
+    return (e == 0u ? m_count : e - 1u);
+  }
+
+}
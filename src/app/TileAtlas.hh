@@ -0,0 +1,179 @@
+#ifndef    TILE_ATLAS_HH
+# define   TILE_ATLAS_HH
+
+# include <memory>
+# include <functional>
+# include <core_utils/CoreObject.hh>
+# include "olcEngine.hh"
+
+namespace pge {
+  namespace tiles {
+
+    /// @brief - Convenience define for a function providing a
+    /// color for a tile based on its value.
+    using ColorProvider = std::function<olc::Pixel(unsigned)>;
+
+  }
+
+  /// @brief - Pre-rendered visuals for the tiles of the board. Each
+  /// tile (its background and its value) is rendered once in an
+  /// offscreen sprite, which allows to draw a tile with a single
+  /// decal rather than rendering its text at each frame. The atlas
+  /// is rebuilt once the size of the tiles stops changing: in the
+  /// meantime, and for tiles too large to fit in the atlas, tiles
+  /// are drawn directly.
+  /// Only values which are powers of two are handled.
+  class TileAtlas: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new atlas for the tiles with values up to
+       *          `2^count`. No resource is allocated until the first
+       *          call to `update`.
+       * @param count - the number of tiles in the atlas.
+       * @param background - provides the background color of tiles.
+       * @param text - provides the color of the text of the tiles.
+       */
+      TileAtlas(unsigned count,
+                const tiles::ColorProvider& background,
+                const tiles::ColorProvider& text);
+
+      /**
+       * @brief - Release the resources of the atlas.
+       */
+      ~TileAtlas();
+
+      TileAtlas(const TileAtlas&) = delete;
+
+      TileAtlas&
+      operator=(const TileAtlas&) = delete;
+
+      /**
+       * @brief - Request the atlas to be rendered for tiles of the
+       *          specified size. The atlas is built right away the
+       *          first time and otherwise when `settle` detects it
+       *          did not change for a while.
+       *          Should be called from the rendering thread.
+       * @param pge - the engine used to render the tiles.
+       * @param size - the size of a tile in pixels.
+       */
+      void
+      update(olc::PixelGameEngine* pge, unsigned size);
+
+      /**
+       * @brief - Rebuild the atlas if the requested size of the
+       *          tiles did not change for long enough.
+       *          Should be called from the rendering thread.
+       * @param pge - the engine used to render the tiles.
+       * @param tDelta - the time elapsed since the last call in
+       *                 seconds.
+       * @return - `true` if the atlas was rebuilt.
+       */
+      bool
+      settle(olc::PixelGameEngine* pge, float tDelta);
+
+      /**
+       * @brief - Whether the atlas is waiting for the size of the
+       *          tiles to settle before being rebuilt.
+       * @return - `true` if a rebuild is pending.
+       */
+      bool
+      pending() const noexcept;
+
+      /**
+       * @brief - Draw the tile with the specified value.
+       * @param pge - the engine to use to perform the rendering.
+       * @param value - the value of the tile.
+       * @param pos - the position of the top left corner of the
+       *              tile in pixels.
+       * @param size - the size of the tile in pixels.
+       * @return - `false` if the value is not handled by the atlas,
+       *           in which case nothing is drawn.
+       */
+      bool
+      draw(olc::PixelGameEngine* pge,
+           unsigned value,
+           const olc::vf2d& pos,
+           const olc::vf2d& size) const;
+
+    private:
+
+      /**
+       * @brief - Render all the tiles in the atlas sprite with the
+       *          current size.
+       * @param pge - the engine used to render the tiles.
+       */
+      void
+      build(olc::PixelGameEngine* pge);
+
+      /**
+       * @brief - Compute the scale and the position of the text of
+       *          a tile so that it is centered in it.
+       * @param pge - the engine used to measure the text.
+       * @param str - the text of the tile.
+       * @param size - the size of the tile in pixels.
+       * @param scale - output argument receiving the scale of the
+       *                text.
+       * @return - the offset of the text from the top left corner
+       *           of the tile.
+       */
+      olc::vi2d
+      layout(olc::PixelGameEngine* pge,
+             const std::string& str,
+             unsigned size,
+             unsigned& scale) const;
+
+      /**
+       * @brief - Clear the sprite and decal of the atlas.
+       */
+      void
+      release() noexcept;
+
+      /**
+       * @brief - Returns the index of the tile in the atlas for the
+       *          input value.
+       * @param value - the value of the tile.
+       * @return - the index of the tile or a value larger than the
+       *           count of tiles if the value is not handled.
+       */
+      unsigned
+      indexOf(unsigned value) const noexcept;
+
+    private:
+
+      /**
+       * @brief - The number of tiles in the atlas.
+       */
+      unsigned m_count;
+
+      /**
+       * @brief - The colors used to render the tiles.
+       */
+      tiles::ColorProvider m_background;
+      tiles::ColorProvider m_text;
+
+      /**
+       * @brief - The size in pixels of a tile in the atlas, `0` if
+       *          it was not built yet.
+       */
+      unsigned m_size;
+
+      /**
+       * @brief - The size of the tiles last requested and the time
+       *          in seconds since it changed.
+       */
+      unsigned m_requested;
+      float m_idle;
+
+      /**
+       * @brief - The sprite where the tiles are rendered and the
+       *          decal used to draw them.
+       */
+      olc::Sprite* m_sprite;
+      olc::Decal* m_decal;
+  };
+
+  using TileAtlasShPtr = std::shared_ptr<TileAtlas>;
+}
+
+#endif    /* TILE_ATLAS_HH */
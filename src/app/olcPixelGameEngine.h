@@ -620,12 +620,17 @@ namespace olc
 		virtual void       PrepareDrawing() = 0;
 		virtual void       DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) = 0;
 		virtual void       DrawDecalQuad(const olc::DecalInstance& decal) = 0;
+		// Draws all the decals of a layer in order: renderers may override this
+		// to submit them in batches
+		virtual void       DrawDecalQuads(const std::vector<olc::DecalInstance>& decals) { for (const auto& decal : decals) DrawDecalQuad(decal); }
 		virtual uint32_t   CreateTexture(const uint32_t width, const uint32_t height) = 0;
 		virtual void       UpdateTexture(uint32_t id, olc::Sprite* spr) = 0;
 		virtual uint32_t   DeleteTexture(const uint32_t id) = 0;
 		virtual void       ApplyTexture(uint32_t id) = 0;
 		virtual void       UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) = 0;
 		virtual void       ClearBuffer(olc::Pixel p, bool bDepth) = 0;
+		// Returns the last composed frame for the renderers keeping it in memory
+		virtual olc::Sprite* GetFrameSprite() { return nullptr; }
 		static olc::PixelGameEngine* ptrPGE;
 	};
 
@@ -642,6 +647,9 @@ namespace olc
 		virtual olc::rcode SetWindowTitle(const std::string& s) = 0;
 		virtual olc::rcode StartSystemEventLoop() = 0;
 		virtual olc::rcode HandleSystemEvent() = 0;
+		// Blocks until a system event is available or the timeout (in seconds)
+		// expires. Platforms which can't wait for events return FAIL
+		virtual olc::rcode WaitSystemEvent(float /*fTimeout*/) { return olc::rcode::FAIL; }
 		static olc::PixelGameEngine* ptrPGE;
 	};
 
@@ -671,6 +679,10 @@ namespace olc
 		virtual bool OnUserUpdate(float fElapsedTime);
 		// Called once on application termination, so you can be one clean coder
 		virtual bool OnUserDestroy();
+		// Called for each change of state of a key, in the order received from
+		// the system and before the next OnUserUpdate: unlike GetKey() several
+		// presses of a key within a single frame are all reported
+		virtual void OnKeyStateChanged(olc::Key key, bool bPressed);
 
 	public: // Hardware Interfaces
 		// Returns true if window is currently in focus
@@ -710,12 +722,22 @@ namespace olc
 		uint32_t GetFPS() const;
 		// Gets last update of elapsed time
 		float GetElapsedTime() const;
+		// Wait for the specified duration (in seconds) before starting the next
+		// frame. If bWakeOnEvent is set the wait stops as soon as a system event
+		// (input, window...) is received
+		void SetFrameWait(float fDuration, bool bWakeOnEvent);
 		// Gets Actual Window size
 		const olc::vi2d& GetWindowSize() const;
 		// Gets pixel scale
 		const olc::vi2d& GetPixelSize() const;
 		// Gets actual pixel scale
 		const olc::vi2d& GetScreenPixelSize() const;
+		// Renders the frames in memory instead of a window: no display server nor
+		// GPU is needed. Must be called before Start()
+		void EnableHeadless();
+		// Gets the last frame composed by the renderer, only available when the
+		// engine is headless (nullptr otherwise)
+		olc::Sprite* GetFrameSprite() const;
 
 	public: // CONFIGURATION ROUTINES
 		// Layer targeting functions
@@ -842,6 +864,8 @@ namespace olc
 		bool		bEnableVSYNC = false;
 		float		fFrameTimer = 1.0f;
 		float		fLastElapsed = 0.0f;
+		float		fFrameWait = 0.0f;
+		bool		bWakeOnEvent = false;
 		int			nFrameCount = 0;
 		Sprite*     fontSprite = nullptr;
 		Decal*      fontDecal = nullptr;
@@ -1583,6 +1607,12 @@ namespace olc
 	float PixelGameEngine::GetElapsedTime() const
 	{ return fLastElapsed; }
 
+	void PixelGameEngine::SetFrameWait(float fDuration, bool bWakeOnEvent)
+	{
+		fFrameWait = fDuration;
+		this->bWakeOnEvent = bWakeOnEvent;
+	}
+
 	const olc::vi2d& PixelGameEngine::GetWindowSize() const
 	{ return vWindowSize; }
 
@@ -2428,6 +2458,9 @@ namespace olc
 
 	bool PixelGameEngine::OnUserDestroy()
 	{ return true; }
+
+	void PixelGameEngine::OnKeyStateChanged(olc::Key key, bool bPressed)
+	{ UNUSED(key); UNUSED(bPressed); }
 	//////////////////////////////////////////////////////////////////
 
 	void PixelGameEngine::olc_UpdateViewport()
@@ -2488,7 +2521,13 @@ namespace olc
 	{ pMouseNewState[button] = state; }
 
 	void PixelGameEngine::olc_UpdateKeyState(int32_t key, bool state)
-	{ pKeyNewState[key] = state; }
+	{
+		// Some platforms report the same key several times per event
+		if (pKeyNewState[key] == state)
+			return;
+		pKeyNewState[key] = state;
+		OnKeyStateChanged(olc::Key(key), state);
+	}
 
 	void PixelGameEngine::olc_UpdateMouseFocus(bool state)
 	{ bHasMouseFocus = state; }
@@ -2548,6 +2587,17 @@ namespace olc
 
 	void PixelGameEngine::olc_CoreUpdate()
 	{
+		// Wait before the frame if requested: platforms which can't wait for
+		// events are polled at short intervals to stay responsive
+		if (fFrameWait > 0.0f)
+		{
+			if (!bWakeOnEvent)
+				std::this_thread::sleep_for(std::chrono::duration<float>(fFrameWait));
+			else if (platform->WaitSystemEvent(fFrameWait) != olc::rcode::OK)
+				std::this_thread::sleep_for(std::chrono::duration<float>(std::min(fFrameWait, 0.01f)));
+			fFrameWait = 0.0f;
+		}
+
 		// Handle Timing
 		m_tp2 = std::chrono::system_clock::now();
 		std::chrono::duration<float> elapsedTime = m_tp2 - m_tp1;
@@ -2624,8 +2674,7 @@ namespace olc
 					
 
 					// Display Decals in order for this layer
-					for (auto& decal : layer->vecDecalInstance)
-						renderer->DrawDecalQuad(decal);
+					renderer->DrawDecalQuads(layer->vecDecalInstance);
 					layer->vecDecalInstance.clear();
 				}
 				else
@@ -2731,6 +2780,7 @@ namespace olc
 		#include <X11/X.h>
 		#include <X11/Xlib.h>
 	}
+	#include <sys/select.h>
 
 	typedef int(glSwapInterval_t)(X11::Display* dpy, X11::GLXDrawable drawable, int interval);
 	static glSwapInterval_t* glSwapIntervalEXT;
@@ -2766,6 +2816,12 @@ namespace olc
 		X11::XVisualInfo* olc_VisualInfo = nullptr;
 #endif
 
+		// Vertices of the decals of a layer, kept between frames to avoid
+		// allocating them again
+		std::vector<GLfloat> vBatchPos;
+		std::vector<GLfloat> vBatchUV;
+		std::vector<GLubyte> vBatchCol;
+
 	public:
 		void PrepareDevice() override
 		{
@@ -2945,6 +3001,65 @@ namespace olc
 			}
 		}
 
+		void DrawDecalQuads(const std::vector<olc::DecalInstance>& decals) override
+		{
+			if (decals.empty()) return;
+
+			// Gather the vertices of all the decals in a single buffer
+			size_t n = decals.size() * 4;
+			vBatchPos.resize(n * 2);
+			vBatchUV.resize(n * 4);
+			vBatchCol.resize(n * 4);
+
+			for (size_t i = 0; i < decals.size(); i++)
+			{
+				const olc::DecalInstance& decal = decals[i];
+				for (size_t j = 0; j < 4; j++)
+				{
+					size_t v = i * 4 + j;
+					vBatchPos[v * 2 + 0] = decal.pos[j].x;
+					vBatchPos[v * 2 + 1] = decal.pos[j].y;
+					vBatchUV[v * 4 + 0] = decal.uv[j].x;
+					vBatchUV[v * 4 + 1] = decal.uv[j].y;
+					vBatchUV[v * 4 + 2] = 0.0f;
+					vBatchUV[v * 4 + 3] = decal.w[j];
+
+					// Only untextured decals have a colour per vertex
+					const olc::Pixel& c = (decal.decal == nullptr ? decal.tint[j] : decal.tint[0]);
+					vBatchCol[v * 4 + 0] = c.r;
+					vBatchCol[v * 4 + 1] = c.g;
+					vBatchCol[v * 4 + 2] = c.b;
+					vBatchCol[v * 4 + 3] = c.a;
+				}
+			}
+
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glEnableClientState(GL_COLOR_ARRAY);
+			glVertexPointer(2, GL_FLOAT, 0, vBatchPos.data());
+			glTexCoordPointer(4, GL_FLOAT, 0, vBatchUV.data());
+			glColorPointer(4, GL_UNSIGNED_BYTE, 0, vBatchCol.data());
+
+			// Issue a single draw call for each run of consecutive decals using
+			// the same texture: this preserves the order of the decals
+			size_t start = 0;
+			while (start < decals.size())
+			{
+				int32_t id = (decals[start].decal == nullptr ? 0 : decals[start].decal->id);
+				size_t end = start + 1;
+				while (end < decals.size() && (decals[end].decal == nullptr ? 0 : decals[end].decal->id) == id)
+					end++;
+
+				glBindTexture(GL_TEXTURE_2D, GLuint(id));
+				glDrawArrays(GL_QUADS, GLint(start * 4), GLsizei((end - start) * 4));
+				start = end;
+			}
+
+			glDisableClientState(GL_COLOR_ARRAY);
+			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+			glDisableClientState(GL_VERTEX_ARRAY);
+		}
+
 		uint32_t CreateTexture(const uint32_t width, const uint32_t height) override
 		{
 			UNUSED(width);
@@ -3222,8 +3337,34 @@ namespace olc
 			return olc::rcode::FAIL;
 		}
 
-		olc::rcode SaveImageResource(olc::Sprite* /*spr*/, const std::string& /*sImageFile*/) override
+		olc::rcode SaveImageResource(olc::Sprite* spr, const std::string& sImageFile) override
 		{
+			if (spr == nullptr || spr->pColData == nullptr) return olc::rcode::FAIL;
+
+			FILE* fp = fopen(sImageFile.c_str(), "wb");
+			if (fp == nullptr) return olc::rcode::NO_FILE;
+
+			png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+			png_infop info = (png ? png_create_info_struct(png) : NULL);
+			if (!png || !info || setjmp(png_jmpbuf(png)))
+			{
+				png_destroy_write_struct(&png, &info);
+				fclose(fp);
+				return olc::rcode::FAIL;
+			}
+
+			png_init_io(png, fp);
+			png_set_IHDR(png, info, spr->width, spr->height, 8, PNG_COLOR_TYPE_RGBA,
+				PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+			png_write_info(png, info);
+
+			// Pixels are stored as RGBA bytes so the rows are written in place
+			for (int y = 0; y < spr->height; y++)
+				png_write_row(png, (png_const_bytep)(spr->pColData + y * spr->width));
+
+			png_write_end(png, NULL);
+			png_destroy_write_struct(&png, &info);
+			fclose(fp);
 			return olc::rcode::OK;
 		}
 	};
@@ -3733,6 +3874,27 @@ namespace olc
 			}
 			return olc::OK;
 		}
+
+		virtual olc::rcode WaitSystemEvent(float fTimeout) override
+		{
+			using namespace X11;
+			// Don't wait if events are already queued
+			XFlush(olc_Display);
+			if (XPending(olc_Display))
+				return olc::OK;
+
+			// Wait for data on the connection to the X server
+			int fd = XConnectionNumber(olc_Display);
+			fd_set fds;
+			FD_ZERO(&fds);
+			FD_SET(fd, &fds);
+
+			timeval tv;
+			tv.tv_sec = static_cast<long>(fTimeout);
+			tv.tv_usec = static_cast<long>((fTimeout - tv.tv_sec) * 1000000.0f);
+			select(fd + 1, &fds, nullptr, nullptr, &tv);
+			return olc::OK;
+		}
 	};
 }
 #endif
@@ -4001,6 +4163,299 @@ namespace olc {
 
 
 
+// O------------------------------------------------------------------------------O
+// | START HEADLESS: offscreen rendering without any display server or GPU        |
+// O------------------------------------------------------------------------------O
+namespace olc
+{
+	// Renders the frames in memory: layers and decals are composed in a sprite
+	// with the same blending as the OpenGL renderers, nearest sampling and
+	// clamped texture coordinates. Textures are not copied, the sprites given
+	// to UpdateTexture are sampled directly
+	class Renderer_Software : public olc::Renderer
+	{
+	private:
+		std::unique_ptr<olc::Sprite> pFrame;
+		std::map<uint32_t, olc::Sprite*> mapTextures;
+		uint32_t nNextTexture = 1;
+		uint32_t nActiveTexture = 0;
+
+		static uint8_t Modulate(uint8_t a, uint8_t b)
+		{
+			return uint8_t((uint32_t(a) * uint32_t(b) + 127) / 255);
+		}
+
+		static olc::Pixel Modulate(const olc::Pixel& a, const olc::Pixel& b)
+		{
+			return olc::Pixel(Modulate(a.r, b.r), Modulate(a.g, b.g), Modulate(a.b, b.b), Modulate(a.a, b.a));
+		}
+
+		// Equivalent to glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+		static void Blend(olc::Pixel& dst, const olc::Pixel& src)
+		{
+			if (src.a == 255) { dst = src; return; }
+			if (src.a == 0) return;
+			uint32_t a = src.a, ia = 255 - src.a;
+			dst = olc::Pixel(
+				uint8_t((src.r * a + dst.r * ia + 127) / 255),
+				uint8_t((src.g * a + dst.g * ia + 127) / 255),
+				uint8_t((src.b * a + dst.b * ia + 127) / 255),
+				uint8_t((src.a * a + dst.a * ia + 127) / 255));
+		}
+
+		static olc::Pixel Sample(const olc::Sprite* spr, float u, float v)
+		{
+			int32_t x = std::clamp(int32_t(std::floor(u * float(spr->width))), 0, spr->width - 1);
+			int32_t y = std::clamp(int32_t(std::floor(v * float(spr->height))), 0, spr->height - 1);
+			return spr->pColData[y * spr->width + x];
+		}
+
+		olc::Sprite* Texture(uint32_t id) const
+		{
+			auto it = mapTextures.find(id);
+			if (it == mapTextures.end() || it->second == nullptr || it->second->pColData == nullptr) return nullptr;
+			return it->second;
+		}
+
+		// Converts a position in normalized device coordinates to the frame
+		olc::vf2d ToFrame(const olc::vf2d& p) const
+		{
+			return { (p.x + 1.0f) * 0.5f * float(pFrame->width), (1.0f - p.y) * 0.5f * float(pFrame->height) };
+		}
+
+		// Fills the pixels whose center lies in the rectangle [x0; x1[ x [y0; y1[
+		// with texture coordinates varying linearly from uv0 to uv1
+		void DrawRect(olc::Sprite* spr, float x0, float y0, float x1, float y1, olc::vf2d uv0, olc::vf2d uv1, const olc::Pixel& tint)
+		{
+			if (x1 < x0) { std::swap(x0, x1); std::swap(uv0.x, uv1.x); }
+			if (y1 < y0) { std::swap(y0, y1); std::swap(uv0.y, uv1.y); }
+
+			int32_t xs = std::max(int32_t(std::ceil(x0 - 0.5f)), 0), xe = std::min(int32_t(std::ceil(x1 - 0.5f)), pFrame->width);
+			int32_t ys = std::max(int32_t(std::ceil(y0 - 0.5f)), 0), ye = std::min(int32_t(std::ceil(y1 - 0.5f)), pFrame->height);
+			if (xs >= xe || ys >= ye) return;
+
+			float du = (uv1.x - uv0.x) / (x1 - x0), dv = (uv1.y - uv0.y) / (y1 - y0);
+			for (int32_t y = ys; y < ye; y++)
+			{
+				olc::Pixel* row = pFrame->pColData + y * pFrame->width;
+				float v = uv0.y + (float(y) + 0.5f - y0) * dv;
+				for (int32_t x = xs; x < xe; x++)
+				{
+					olc::Pixel c = (spr == nullptr ? tint : Modulate(Sample(spr, uv0.x + (float(x) + 0.5f - x0) * du, v), tint));
+					Blend(row[x], c);
+				}
+			}
+		}
+
+		// Fills the pixels whose center lies in the triangle (a, b, c) of the decal,
+		// interpolating the texture coordinates with perspective and the tints
+		void DrawTriangle(olc::Sprite* spr, const olc::DecalInstance& decal, const olc::vf2d* p, int a, int b, int c)
+		{
+			auto edge = [](const olc::vf2d& p0, const olc::vf2d& p1, float x, float y)
+			{ return (p1.x - p0.x) * (y - p0.y) - (p1.y - p0.y) * (x - p0.x); };
+
+			float area = edge(p[a], p[b], p[c].x, p[c].y);
+			if (area == 0.0f) return;
+
+			int32_t xs = std::max(int32_t(std::floor(std::min({ p[a].x, p[b].x, p[c].x }))), 0);
+			int32_t xe = std::min(int32_t(std::ceil(std::max({ p[a].x, p[b].x, p[c].x }))), pFrame->width);
+			int32_t ys = std::max(int32_t(std::floor(std::min({ p[a].y, p[b].y, p[c].y }))), 0);
+			int32_t ye = std::min(int32_t(std::ceil(std::max({ p[a].y, p[b].y, p[c].y }))), pFrame->height);
+
+			for (int32_t y = ys; y < ye; y++)
+			{
+				for (int32_t x = xs; x < xe; x++)
+				{
+					float px = float(x) + 0.5f, py = float(y) + 0.5f;
+					float la = edge(p[b], p[c], px, py) / area;
+					float lb = edge(p[c], p[a], px, py) / area;
+					float lc = 1.0f - la - lb;
+					if (la < 0.0f || lb < 0.0f || lc < 0.0f) continue;
+
+					auto lerp = [&](float va, float vb, float vc) { return la * va + lb * vb + lc * vc; };
+					olc::Pixel tint(
+						uint8_t(lerp(decal.tint[a].r, decal.tint[b].r, decal.tint[c].r) + 0.5f),
+						uint8_t(lerp(decal.tint[a].g, decal.tint[b].g, decal.tint[c].g) + 0.5f),
+						uint8_t(lerp(decal.tint[a].b, decal.tint[b].b, decal.tint[c].b) + 0.5f),
+						uint8_t(lerp(decal.tint[a].a, decal.tint[b].a, decal.tint[c].a) + 0.5f));
+
+					olc::Pixel col = tint;
+					if (spr != nullptr)
+					{
+						float w = lerp(decal.w[a], decal.w[b], decal.w[c]);
+						col = Modulate(Sample(spr,
+							lerp(decal.uv[a].x, decal.uv[b].x, decal.uv[c].x) / w,
+							lerp(decal.uv[a].y, decal.uv[b].y, decal.uv[c].y) / w), tint);
+					}
+					Blend(pFrame->pColData[y * pFrame->width + x], col);
+				}
+			}
+		}
+
+	public:
+		void PrepareDevice() override
+		{}
+
+		olc::rcode CreateDevice(std::vector<void*> params, bool bFullScreen, bool bVSYNC) override
+		{
+			UNUSED(params);
+			UNUSED(bFullScreen);
+			UNUSED(bVSYNC);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode DestroyDevice() override
+		{
+			pFrame.reset();
+			mapTextures.clear();
+			return olc::rcode::OK;
+		}
+
+		void DisplayFrame() override
+		{}
+
+		void PrepareDrawing() override
+		{}
+
+		void DrawLayerQuad(const olc::vf2d& offset, const olc::vf2d& scale, const olc::Pixel tint) override
+		{
+			olc::Sprite* spr = Texture(nActiveTexture);
+			if (spr == nullptr || !pFrame) return;
+
+			// Fast path for the layers covering exactly the frame
+			if (offset.x == 0.0f && offset.y == 0.0f && scale.x == 1.0f && scale.y == 1.0f &&
+				spr->width == pFrame->width && spr->height == pFrame->height && tint == olc::WHITE)
+			{
+				for (int32_t i = 0; i < pFrame->width * pFrame->height; i++)
+					Blend(pFrame->pColData[i], spr->pColData[i]);
+				return;
+			}
+
+			DrawRect(spr, 0.0f, 0.0f, float(pFrame->width), float(pFrame->height),
+				offset, { scale.x + offset.x, scale.y + offset.y }, tint);
+		}
+
+		void DrawDecalQuad(const olc::DecalInstance& decal) override
+		{
+			if (!pFrame) return;
+
+			olc::Sprite* spr = nullptr;
+			if (decal.decal != nullptr)
+			{
+				spr = Texture(decal.decal->id);
+				if (spr == nullptr) return;
+			}
+
+			olc::vf2d p[4];
+			for (int i = 0; i < 4; i++) p[i] = ToFrame(decal.pos[i]);
+
+			// Most decals are axis aligned rectangles with a uniform tint
+			bool rect =
+				p[0].x == p[1].x && p[2].x == p[3].x && p[0].y == p[3].y && p[1].y == p[2].y &&
+				decal.uv[0].x == decal.uv[1].x && decal.uv[2].x == decal.uv[3].x &&
+				decal.uv[0].y == decal.uv[3].y && decal.uv[1].y == decal.uv[2].y &&
+				decal.w[0] == 1.0f && decal.w[1] == 1.0f && decal.w[2] == 1.0f && decal.w[3] == 1.0f &&
+				decal.tint[0] == decal.tint[1] && decal.tint[0] == decal.tint[2] && decal.tint[0] == decal.tint[3];
+
+			if (rect)
+			{
+				DrawRect(spr, p[0].x, p[0].y, p[2].x, p[2].y, decal.uv[0], decal.uv[2], decal.tint[0]);
+				return;
+			}
+
+			DrawTriangle(spr, decal, p, 0, 1, 2);
+			DrawTriangle(spr, decal, p, 0, 2, 3);
+		}
+
+		uint32_t CreateTexture(const uint32_t width, const uint32_t height) override
+		{
+			UNUSED(width);
+			UNUSED(height);
+			uint32_t id = nNextTexture++;
+			mapTextures[id] = nullptr;
+			return id;
+		}
+
+		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
+		{
+			mapTextures[id] = spr;
+		}
+
+		uint32_t DeleteTexture(const uint32_t id) override
+		{
+			mapTextures.erase(id);
+			return id;
+		}
+
+		void ApplyTexture(uint32_t id) override
+		{
+			nActiveTexture = id;
+		}
+
+		void UpdateViewport(const olc::vi2d& pos, const olc::vi2d& size) override
+		{
+			UNUSED(pos);
+			if (!pFrame || pFrame->width != size.x || pFrame->height != size.y)
+				pFrame = std::make_unique<olc::Sprite>(size.x, size.y);
+		}
+
+		void ClearBuffer(olc::Pixel p, bool bDepth) override
+		{
+			UNUSED(bDepth);
+			if (!pFrame) return;
+			std::fill(pFrame->pColData, pFrame->pColData + pFrame->width * pFrame->height, p);
+		}
+
+		olc::Sprite* GetFrameSprite() override
+		{
+			return pFrame.get();
+		}
+	};
+
+	// No window and no system events: the engine runs its loop as fast as it
+	// is allowed to and the frames are only available through the renderer
+	class Platform_Headless : public olc::Platform
+	{
+	public:
+		olc::rcode ApplicationStartUp() override { return olc::rcode::OK; }
+		olc::rcode ApplicationCleanUp() override { return olc::rcode::OK; }
+		olc::rcode ThreadStartUp() override { return olc::rcode::OK; }
+
+		olc::rcode ThreadCleanUp() override
+		{
+			renderer->DestroyDevice();
+			return olc::rcode::OK;
+		}
+
+		olc::rcode CreateGraphics(bool bFullScreen, bool bEnableVSYNC, const olc::vi2d& vViewPos, const olc::vi2d& vViewSize) override
+		{
+			if (renderer->CreateDevice({}, bFullScreen, bEnableVSYNC) != olc::rcode::OK) return olc::rcode::FAIL;
+			renderer->UpdateViewport(vViewPos, vViewSize);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override
+		{
+			UNUSED(vWindowPos);
+			UNUSED(vWindowSize);
+			UNUSED(bFullScreen);
+			return olc::rcode::OK;
+		}
+
+		olc::rcode SetWindowTitle(const std::string& s) override { UNUSED(s); return olc::rcode::OK; }
+		olc::rcode StartSystemEventLoop() override { return olc::rcode::OK; }
+		olc::rcode HandleSystemEvent() override { return olc::rcode::OK; }
+
+		// No event will ever come: waiting would only slow down the frames
+		olc::rcode WaitSystemEvent(float fTimeout) override { UNUSED(fTimeout); return olc::rcode::OK; }
+	};
+}
+// O------------------------------------------------------------------------------O
+// | END HEADLESS                                                                 |
+// O------------------------------------------------------------------------------O
+
+
+
 namespace olc
 {
 	void PixelGameEngine::olc_ConfigureSystem()
@@ -4051,6 +4506,18 @@ namespace olc
 		platform->ptrPGE = this;
 		renderer->ptrPGE = this;
 	}
+
+	void PixelGameEngine::EnableHeadless()
+	{
+		platform = std::make_unique<olc::Platform_Headless>();
+		renderer = std::make_unique<olc::Renderer_Software>();
+
+		platform->ptrPGE = this;
+		renderer->ptrPGE = this;
+	}
+
+	olc::Sprite* PixelGameEngine::GetFrameSprite() const
+	{ return renderer->GetFrameSprite(); }
 }
 
 #endif // End olc namespace
@@ -17,7 +17,9 @@ namespace pge {
     m_tScaled(m_ts),
 
     m_translationOrigin(),
-    m_cachedPOrigin()
+    m_cachedPOrigin(),
+
+    m_revision(0u)
   {
     setService("coordinate");
 
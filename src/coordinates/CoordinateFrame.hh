@@ -67,6 +67,16 @@ namespace pge {
       olc::vf2d
       tileSize() const noexcept;
 
+      /**
+       * @brief - Returns a counter incremented each time the frame
+       *          is zoomed or translated. This allows to cache data
+       *          computed from the frame and to detect when it has
+       *          to be computed again.
+       * @return - the revision of the frame.
+       */
+      unsigned
+      revision() const noexcept;
+
       /**
        * @brief - Return the current viewport expressed in cells.
        *          This interface should be specialized by inheriting
@@ -252,6 +262,12 @@ namespace pge {
        *          to update the viewport accordingly.
        */
       olc::vi2d m_cachedPOrigin;
+
+      /**
+       * @brief - The revision of the frame, incremented whenever the
+       *          conversion between cells and pixels changes.
+       */
+      unsigned m_revision;
   };
 
   using CoordinateFrameShPtr = std::shared_ptr<CoordinateFrame>;
@@ -18,6 +18,12 @@ namespace pge {
     return m_scale * m_ts;
   }
 
+  inline
+  unsigned
+  CoordinateFrame::revision() const noexcept {
+    return m_revision;
+  }
+
   inline
   void
   CoordinateFrame::zoomIn(const olc::vf2d& pos) {
@@ -45,6 +51,7 @@ namespace pge {
     // the final position of the viewport.
     olc::vf2d translation = pos - m_translationOrigin;
     m_pViewport.topLeft() = m_cachedPOrigin + translation;
+    ++m_revision;
   }
 
   inline
@@ -69,6 +76,7 @@ namespace pge {
     m_cViewport.dims() *= factor;
 
     updateTileScale();
+    ++m_revision;
   }
 
 }
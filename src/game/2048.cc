@@ -1,12 +1,30 @@
 
 # include "2048.hh"
+# include "PackedBoard.hh"
+
+/// @brief - The maximum number of spawns explored by the
+/// adversarial opponent.
+# define OPPONENT_DEPTH 4u
+
+/// @brief - The target duration in microseconds to find the
+/// worst spawn: it should be well within a frame at 144Hz. It
+/// is a soft target, see the `Opponent` class.
+# define OPPONENT_LATENCY_CAP 2000.0f
+
+/// @brief - The number of nodes explored to find the worst spawn
+/// when the game should be deterministic: this takes about as long
+/// as the latency cap on a regular board.
+# define OPPONENT_NODE_BUDGET 2000u
 
 namespace two48 {
 
   Game::Game(unsigned width, unsigned height, unsigned depth) noexcept:
     utils::CoreObject("board"),
 
-    m_board(width, height, depth)
+    m_board(width, height, depth),
+
+    m_adversarial(false),
+    m_opponent(OPPONENT_DEPTH, OPPONENT_LATENCY_CAP)
   {
     setService("2048");
 
@@ -60,42 +78,46 @@ namespace two48 {
 
   unsigned
   Game::moveHorizontally(bool positive,
-                         bool& valid)
+                         bool& valid,
+                         Trace* trace)
   {
     // Check whether the move is valid.
     valid = m_board.canMoveHorizontally(positive);
     if (!valid) {
+      if (trace != nullptr) {
+        trace->clear();
+      }
+
       return 0u;
     }
 
     // Handle the move.
-    unsigned s = m_board.moveHorizontally(positive);
+    unsigned s = m_board.moveHorizontally(positive, trace);
 
-    // Spawn a random tile: the value is set between
-    // 2 and 4 with a strong bias towards 2.
-    unsigned v = std::rand() % 100u < 90u ? 2u : 4u;
-    m_board.spawn(v);
+    spawn();
 
     return s;
   }
 
   unsigned
   Game::moveVertically(bool positive,
-                       bool& valid)
+                       bool& valid,
+                       Trace* trace)
   {
     // Check whether the move is valid.
     valid = m_board.canMoveVertically(positive);
     if (!valid) {
+      if (trace != nullptr) {
+        trace->clear();
+      }
+
       return 0u;
     }
 
     // Handle the move.
-    unsigned s = m_board.moveVertically(positive);
+    unsigned s = m_board.moveVertically(positive, trace);
 
-    // Spawn a random tile: the value is set between
-    // 2 and 4 with a strong bias towards 2.
-    unsigned v = std::rand() % 100u < 90u ? 2u : 4u;
-    m_board.spawn(v);
+    spawn();
 
     return s;
   }
@@ -110,6 +132,39 @@ namespace two48 {
     ;
   }
 
+  bool
+  Game::adversarial() const noexcept {
+    return m_adversarial;
+  }
+
+  void
+  Game::setAdversarial(bool adversarial) noexcept {
+    m_adversarial = adversarial;
+  }
+
+  void
+  Game::setDeterministic(bool deterministic) noexcept {
+    m_opponent.setNodeBudget(deterministic ? OPPONENT_NODE_BUDGET : 0u);
+  }
+
+  void
+  Game::spawn() {
+    // The opponent works on packed boards: larger boards
+    // always receive random tiles.
+    bool packable = (w() <= PackedBoard::MaxSize && h() <= PackedBoard::MaxSize);
+
+    unsigned x, y, v;
+    if (m_adversarial && packable && m_opponent.spawn(PackedBoard(m_board), x, y, v)) {
+      m_board.spawn(v, x, y);
+      return;
+    }
+
+    // Spawn a random tile: the value is set between
+    // 2 and 4 with a strong bias towards 2.
+    v = std::rand() % 100u < 90u ? 2u : 4u;
+    m_board.spawn(v);
+  }
+
   void
   Game::load(const std::string& file) {
     m_board.load(file);
@@ -6,6 +6,7 @@
 # include <memory>
 # include <core_utils/CoreObject.hh>
 # include "Board.hh"
+# include "Opponent.hh"
 
 namespace two48 {
 
@@ -70,25 +71,34 @@ namespace two48 {
        * @param valid - output argument defining whether the move was
        *                valid. If not then the score will be `0` and
        *                the board won't be modified.
+       * @param trace - if not `null` receives the motion of each
+       *                tile during the move. The spawned tile is
+       *                not part of it.
        * @return - the number of points brought by the move.
        */
       unsigned
       moveHorizontally(bool positive,
-                       bool& valid);
+                       bool& valid,
+                       Trace* trace = nullptr);
 
       /**
        * @brief - Move the pieces in the board with a vertical move
        *          which along the positive or negative axis based on
        *          the value of the input boolean.
-       * @param positive - whether the move is towards positive y.
+       * @param positive - whether the move is towards `y = 0`, i.e.
+       *                   the top of the screen.
        * @param valid - output argument defining whether the move was
        *                valid. If not then the score will be `0` and
        *                the board won't be modified.
+       * @param trace - if not `null` receives the motion of each
+       *                tile during the move. The spawned tile is
+       *                not part of it.
        * @return - the number of points brought by the move.
        */
       unsigned
       moveVertically(bool positive,
-                     bool& valid);
+                     bool& valid,
+                     Trace* trace = nullptr);
 
       /**
        * @brief - Whether the board still have valid moves.
@@ -97,6 +107,36 @@ namespace two48 {
       bool
       canMove() const noexcept;
 
+      /**
+       * @brief - Whether the tiles are spawned by an adversarial
+       *          opponent rather than at random.
+       * @return - `true` if the adversarial mode is active.
+       */
+      bool
+      adversarial() const noexcept;
+
+      /**
+       * @brief - Define whether the tiles should be spawned by an
+       *          adversarial opponent: it picks the location and
+       *          the value of the tile which are the worst for the
+       *          player.
+       * @param adversarial - `true` to activate the adversarial
+       *                      mode.
+       */
+      void
+      setAdversarial(bool adversarial) noexcept;
+
+      /**
+       * @brief - Define whether the spawns of the adversarial mode
+       *          should only depend on the board: the opponent is
+       *          then limited to a number of nodes rather than to
+       *          a duration. This is needed to replay a game.
+       * @param deterministic - `true` to make the spawns only
+       *                        depend on the board.
+       */
+      void
+      setDeterministic(bool deterministic) noexcept;
+
       /**
        * @brief - Loads the content of the board defined in the
        *          input file and use it to replace the content
@@ -120,12 +160,32 @@ namespace two48 {
            unsigned moves,
            unsigned score) const;
 
+    private:
+
+      /**
+       * @brief - Spawn a new tile after a move, either at random or
+       *          with the adversarial opponent.
+       */
+      void
+      spawn();
+
     private:
 
       /**
        * @brief - The current state of the board.
        */
       mutable Board m_board;
+
+      /**
+       * @brief - Whether the tiles are spawned by the opponent.
+       */
+      bool m_adversarial;
+
+      /**
+       * @brief - The opponent used to spawn tiles in adversarial
+       *          mode.
+       */
+      Opponent m_opponent;
   };
 
   using GameShPtr = std::shared_ptr<Game>;
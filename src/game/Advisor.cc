@@ -0,0 +1,158 @@
+
+# include "Advisor.hh"
+# include <core_utils/TimeUtils.hh>
+# include "Tracer.hh"
+
+/// @brief - The maximum number of results kept in the cache.
+/// When this is exceeded the cache is emptied: most results
+/// concern positions that are not reachable anymore.
+# define MAX_CACHED_RESULTS 65536u
+
+namespace two48 {
+
+  Advisor::Advisor(unsigned depth):
+    utils::CoreObject("advisor"),
+
+    m_locker(),
+    m_notifier(),
+    m_running(true),
+
+    m_pending(),
+    m_generation(0u),
+    m_results(),
+
+    m_search(depth),
+    m_worker()
+  {
+    setService("2048");
+
+    // Start the worker once all the attributes are set.
+    m_worker = std::thread(&Advisor::run, this);
+  }
+
+  Advisor::~Advisor() {
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+      m_running = false;
+      m_pending.clear();
+    }
+
+    m_notifier.notify_all();
+    m_worker.join();
+  }
+
+  void
+  Advisor::speculate(const PackedBoard& board) {
+    {
+      std::lock_guard<std::mutex> guard(m_locker);
+
+      ++m_generation;
+      m_pending.clear();
+      m_pending.push_back(Job{board, true});
+    }
+
+    m_notifier.notify_one();
+  }
+
+  bool
+  Advisor::lookup(const PackedBoard& board, Direction& move) const {
+    Symmetry s;
+    PackedBoard c = board.canonical(&s);
+
+    std::lock_guard<std::mutex> guard(m_locker);
+
+    std::unordered_map<Key, Result>::const_iterator it = m_results.find(c.key());
+    if (it == m_results.cend() || it->second.board != c) {
+      return false;
+    }
+
+    move = restore(it->second.move, s);
+    return true;
+  }
+
+  void
+  Advisor::run() {
+    std::unique_lock<std::mutex> lock(m_locker);
+
+    while (m_running) {
+      m_notifier.wait(
+        lock,
+        [this]() {
+          return !m_running || !m_pending.empty();
+        }
+      );
+
+      if (!m_running) {
+        break;
+      }
+
+      Job job = m_pending.front();
+      m_pending.pop_front();
+      unsigned generation = m_generation;
+
+      Symmetry s;
+      PackedBoard c = job.board.canonical(&s);
+
+      // The board may already be known, typically when a
+      // speculation turns out to be right.
+      std::unordered_map<Key, Result>::const_iterator it = m_results.find(c.key());
+      Direction move = Direction::Count;
+
+      if (it != m_results.cend() && it->second.board == c) {
+        move = it->second.move;
+      }
+      else {
+        // Search without holding the lock so that the
+        // results can be queried in the meantime.
+        lock.unlock();
+
+        utils::TimeStamp start = utils::now();
+        move = m_search.best(c);
+
+        utils::TimeStamp end = utils::now();
+        profiling::Tracer::record("evaluate board", "search", start, end);
+
+        verbose(
+          "Evaluated board " + std::to_string(c.key()) + " in " +
+          std::to_string(utils::diffInMs(start, end)) + "ms"
+        );
+
+        lock.lock();
+        registerResult(c, move);
+      }
+
+      // Schedule the likely successors if the board is
+      // still the current one.
+      if (!job.expand || generation != m_generation || move == Direction::Count) {
+        continue;
+      }
+
+      PackedBoard next = job.board;
+      unsigned points = 0u;
+      next.move(restore(move, s), points);
+
+      for (unsigned y = 0u ; y < next.h() ; ++y) {
+        for (unsigned x = 0u ; x < next.w() ; ++x) {
+          if (next.exponent(x, y) != 0u) {
+            continue;
+          }
+
+          PackedBoard spawned = next;
+          spawned.set(x, y, 1u);
+          m_pending.push_back(Job{spawned, false});
+        }
+      }
+    }
+  }
+
+  void
+  Advisor::registerResult(const PackedBoard& board, const Direction& move) {
+    if (m_results.size() >= MAX_CACHED_RESULTS) {
+      debug("Clearing " + std::to_string(m_results.size()) + " cached result(s)");
+      m_results.clear();
+    }
+
+    m_results[board.key()] = Result{board, move};
+  }
+
+}
@@ -0,0 +1,155 @@
+#ifndef    ADVISOR_HH
+# define   ADVISOR_HH
+
+# include <deque>
+# include <mutex>
+# include <thread>
+# include <memory>
+# include <unordered_map>
+# include <condition_variable>
+# include <core_utils/CoreObject.hh>
+# include "PackedBoard.hh"
+# include "Search.hh"
+
+namespace two48 {
+
+  /// @brief - Background worker computing the best move of boards
+  /// ahead of the requests of the player. Each time a new position
+  /// is reached it is scheduled for evaluation, followed by the
+  /// positions most likely to come next: the ones obtained after
+  /// the best move and the spawn of a `2` in any empty cell. The
+  /// results are cached so that a hint can be answered without
+  /// searching on the calling thread.
+  class Advisor: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new advisor and start its worker thread.
+       * @param depth - the depth of the search used to evaluate
+       *                the boards.
+       */
+      explicit
+      Advisor(unsigned depth = 3u);
+
+      /**
+       * @brief - Stop the worker thread: pending evaluations are
+       *          discarded.
+       */
+      ~Advisor();
+
+      Advisor(const Advisor&) = delete;
+
+      Advisor&
+      operator=(const Advisor&) = delete;
+
+      /**
+       * @brief - Schedule the evaluation of the input board and of
+       *          its likely successors. Any evaluation pending for
+       *          a previous board is discarded as it is not likely
+       *          to be needed anymore.
+       * @param board - the board reached by the player.
+       */
+      void
+      speculate(const PackedBoard& board);
+
+      /**
+       * @brief - Fetch the best move for the input board if it has
+       *          already been computed. This never blocks on the
+       *          search.
+       * @param board - the board to search for.
+       * @param move - output argument receiving the best move.
+       * @return - `true` if the move is available.
+       */
+      bool
+      lookup(const PackedBoard& board, Direction& move) const;
+
+    private:
+
+      /// @brief - A board waiting to be evaluated.
+      struct Job {
+        // The board to evaluate.
+        PackedBoard board;
+
+        // Whether the successors of the board should also be
+        // scheduled once its best move is known.
+        bool expand;
+      };
+
+      /// @brief - A result of the search: moves are expressed for
+      /// the canonical board, which is kept to detect collisions
+      /// of the keys on large boards.
+      struct Result {
+        PackedBoard board;
+        Direction move;
+      };
+
+      /**
+       * @brief - Main loop of the worker thread: evaluate boards as
+       *          long as some are pending.
+       */
+      void
+      run();
+
+      /**
+       * @brief - Register the best move of a board in the cache.
+       *          Assumes that the locker is already acquired.
+       * @param board - the canonical board.
+       * @param move - the best move for this board.
+       */
+      void
+      registerResult(const PackedBoard& board, const Direction& move);
+
+    private:
+
+      /**
+       * @brief - Protects the pending jobs and the results from
+       *          concurrent accesses.
+       */
+      mutable std::mutex m_locker;
+
+      /**
+       * @brief - Notified when new jobs are available or when the
+       *          worker should stop.
+       */
+      std::condition_variable m_notifier;
+
+      /**
+       * @brief - Whether the worker should keep running.
+       */
+      bool m_running;
+
+      /**
+       * @brief - The boards waiting to be evaluated, in order of
+       *          priority.
+       */
+      std::deque<Job> m_pending;
+
+      /**
+       * @brief - Incremented each time a new board is reached: it
+       *          allows to not schedule the successors of a board
+       *          which is not relevant anymore.
+       */
+      unsigned m_generation;
+
+      /**
+       * @brief - The best moves computed so far, keyed by the key
+       *          of the canonical boards.
+       */
+      std::unordered_map<Key, Result> m_results;
+
+      /**
+       * @brief - The search used by the worker: only accessed by
+       *          the worker thread.
+       */
+      Search m_search;
+
+      /**
+       * @brief - The worker thread.
+       */
+      std::thread m_worker;
+  };
+
+  using AdvisorShPtr = std::shared_ptr<Advisor>;
+}
+
+#endif    /* ADVISOR_HH */
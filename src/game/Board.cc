@@ -2,6 +2,27 @@
 # include "Board.hh"
 # include <cmath>
 # include <fstream>
+# include "Tracer.hh"
+
+namespace {
+
+  /// @brief - The index of the flag of a move in the summary of
+  /// the moves possible in a row.
+  inline
+  unsigned
+  moveIndex(bool horizontal, bool positive) noexcept {
+    return (horizontal ? 0u : 2u) + (positive ? 1u : 0u);
+  }
+
+  /// @brief - The flag of a move in the summary of the moves
+  /// possible in a row.
+  inline
+  uint8_t
+  moveFlag(bool horizontal, bool positive) noexcept {
+    return static_cast<uint8_t>(1u << moveIndex(horizontal, positive));
+  }
+
+}
 
 namespace two48 {
 
@@ -15,10 +36,22 @@ namespace two48 {
 
     m_board(w() * h(), 0u),
 
+    m_words((width + 63u) / 64u),
+    m_occupancy(h() * m_words, 0u),
+    m_rowTiles(h(), 0u),
+    m_empty(w() * h()),
+
+    m_moves(h(), 0u),
+    m_movable(),
+    m_dirtyRows(),
+    m_dirty(h(), false),
+
     m_undoStackDepth(depth),
     m_undoStack()
   {
     setService("2048");
+
+    m_movable.fill(0u);
   }
 
   unsigned
@@ -55,121 +88,66 @@ namespace two48 {
     return m_board[linear(x, y)];
   }
 
+  unsigned
+  Board::emptyCells() const noexcept {
+    return m_empty;
+  }
+
   bool
   Board::canMoveHorizontally(bool positive) const noexcept {
-    // We have to make sure that at least one tile can be
-    // moved to the corresponding direction or merged.
-    bool valid = false;
-
-    unsigned y = 0u;
-    while (y < h() && !valid) {
-      // Scan the line and check if:
-      // - there are two consecutive digits with the same
-      //   value.
-      // - there is a space on the right direction compared
-      //   to the sense of the move.
-      unsigned lastDigit = 0u;
-
-      unsigned x = 0u;
-      while (x < w() && !valid) {
-        unsigned id = (positive ? y * w() + w() - 1u - x : y * w() + x);
-
-        // Case of same consiecutive digits.
-        if (lastDigit != 0u && lastDigit == m_board[id]) {
-          valid = true;
-        }
-
-        // Case of an empty space after a central digit. Note
-        // that we need to make sure that it's not the first
-        // digit.
-        if (lastDigit == 0u && m_board[id] != 0u &&
-            ((positive && id % w() != w() - 1u) || (!positive && id % w() != 0u)))
-        {
-          valid = true;
-        }
-
-        lastDigit = m_board[id];
-
-        ++x;
-      }
-
-      ++y;
-    }
-
-    return valid;
+    return m_movable[moveIndex(true, positive)] > 0u;
   }
 
   bool
   Board::canMoveVertically(bool positive) const noexcept {
-    // We have to make sure that at least one tile can be
-    // moved to the corresponding direction or merged.
-    bool valid = false;
-
-    unsigned x = 0u;
-    while (x < w() && !valid) {
-      // Scan the line and check if:
-      // - there are two consecutive digits with the same
-      //   value.
-      // - there is a space on the right direction compared
-      //   to the sense of the move.
-      unsigned lastDigit = 0u;
-
-      unsigned y = 0u;
-      while (y < h() && !valid) {
-        unsigned id = (positive ? y * w() + x : (h() - 1u - y) * w() + x);
-
-        // Case of same consiecutive digits.
-        if (lastDigit != 0u && lastDigit == m_board[id]) {
-          valid = true;
-        }
-
-        // Case of an empty space after a central digit. Note
-        // that we need to make sure that it's not the first
-        // digit.
-        if (lastDigit == 0u && m_board[id] != 0u &&
-            ((positive && id / w() != 0) || (!positive && id / w() != h() - 1u)))
-        {
-          valid = true;
-        }
-
-        lastDigit = m_board[id];
-
-        ++y;
-      }
-
-      ++x;
-    }
-
-    return valid;
+    return m_movable[moveIndex(false, positive)] > 0u;
   }
 
   unsigned
-  Board::moveHorizontally(bool positive) {
+  Board::moveHorizontally(bool positive, Trace* trace) {
+    profiling::Span span("move horizontally", "board");
+
     // Save the current state of the board.
     saveBoard();
 
+    if (trace != nullptr) {
+      trace->clear();
+    }
+
     // Move each row horizontally and accumulate the score.
     unsigned score = 0u;
 
     for (unsigned y = 0u ; y < h() ; ++y) {
-      score += collapseRow(y, positive);
+      if (m_rowTiles[y] > 0u) {
+        score += collapseRow(y, positive, trace);
+      }
     }
 
+    updateMoves();
+
     return score;
   }
 
   unsigned
-  Board::moveVertically(bool positive) {
+  Board::moveVertically(bool positive, Trace* trace) {
+    profiling::Span span("move vertically", "board");
+
     // Save the current state of the board.
     saveBoard();
 
+    if (trace != nullptr) {
+      trace->clear();
+    }
+
     // Move each column horizontally and accumulate the score.
     unsigned score = 0u;
 
     for (unsigned x = 0u ; x < w() ; ++x) {
-      score += collapseColumn(x, positive);
+      score += collapseColumn(x, positive, trace);
     }
 
+    updateMoves();
+
     return score;
   }
 
@@ -177,28 +155,67 @@ namespace two48 {
   Board::reset() noexcept {
     m_board = std::vector<unsigned>(w() * h(), 0u);
     m_undoStack.clear();
+
+    updateOccupancy();
   }
 
   bool
   Board::spawn(unsigned value) noexcept {
-    // Gather available cells.
-    std::vector<unsigned> availables;
+    if (m_empty == 0u) {
+      return false;
+    }
 
-    for (unsigned id = 0u ; id < m_board.size() ; ++id) {
-      if (m_board[id] == 0u) {
-        availables.push_back(id);
+    // Pick a random empty cell, counted row after row: the
+    // number of tiles of each row allows to find the row of
+    // the cell and only its occupancy is scanned.
+    unsigned k = std::rand() % m_empty;
+
+    unsigned y = 0u;
+    while (k >= w() - m_rowTiles[y]) {
+      k -= w() - m_rowTiles[y];
+      ++y;
+    }
+
+    unsigned x = 0u;
+    for (unsigned i = 0u ; i < m_words ; ++i) {
+      uint64_t free = ~occupancy(y, i);
+      if (i + 1u == m_words && w() % 64u != 0u) {
+        free &= (uint64_t(1u) << (w() % 64u)) - 1u;
+      }
+
+      unsigned count = static_cast<unsigned>(__builtin_popcountll(free));
+      if (k >= count) {
+        k -= count;
+        continue;
       }
+
+      while (k > 0u) {
+        free &= free - 1u;
+        --k;
+      }
+
+      x = i * 64u + static_cast<unsigned>(__builtin_ctzll(free));
+      break;
     }
 
-    if (availables.empty()) {
+    setCell(x, y, value);
+    updateMoves();
+
+    verbose("Spawning " + std::to_string(value) + " at " + std::to_string(x) + "x" + std::to_string(y));
+
+    return true;
+  }
+
+  bool
+  Board::spawn(unsigned value, unsigned x, unsigned y) noexcept {
+    if (x >= w() || y >= h() || m_board[linear(x, y)] != 0u) {
       return false;
     }
 
-    // Pick a random location and spawn the number.
-    unsigned id = availables[std::rand() % availables.size()];
-    m_board[id] = value;
+    setCell(x, y, value);
+    updateMoves();
 
-    verbose("Spawning " + std::to_string(value) + " at " + std::to_string(id % w()) + "x" + std::to_string(id / w()));
+    verbose("Spawning " + std::to_string(value) + " at " + std::to_string(x) + "x" + std::to_string(y));
 
     return true;
   }
@@ -215,6 +232,8 @@ namespace two48 {
 
     m_board = m_undoStack.back();
     m_undoStack.pop_back();
+
+    updateOccupancy();
   }
 
   bool
@@ -227,6 +246,8 @@ namespace two48 {
               unsigned moves,
               unsigned score) const
   {
+    profiling::Span span("save board", "io");
+
     // Open the file and verify that it is valid.
     std::ofstream out(file.c_str());
     if (!out.good()) {
@@ -283,6 +304,8 @@ namespace two48 {
 
   void
   Board::load(const std::string& file) {
+    profiling::Span span("load board", "io");
+
     // Open the file and verify that it is valid.
     std::ifstream out(file.c_str());
     if (!out.good()) {
@@ -334,6 +357,8 @@ namespace two48 {
       m_undoStack.push_back(state);
     }
 
+    updateOccupancy();
+
     info(
       "Loaded board with dimensions " + std::to_string(m_width) + "x" +
       std::to_string(m_height) + " with undo stack of " +
@@ -347,16 +372,218 @@ namespace two48 {
     return y * m_width + x;
   }
 
+  inline
+  void
+  Board::setCell(unsigned x, unsigned y, unsigned value) noexcept {
+    unsigned id = linear(x, y);
+    if (m_board[id] == value) {
+      return;
+    }
+
+    bool was = (m_board[id] != 0u);
+    bool is = (value != 0u);
+
+    m_board[id] = value;
+
+    // Any change of value might change the tiles which can
+    // be merged. The vertical moves of the previous row also
+    // depend on the content of this one.
+    invalidateMoves(y);
+    if (y > 0u) {
+      invalidateMoves(y - 1u);
+    }
+
+    if (was == is) {
+      return;
+    }
+
+    uint64_t bit = uint64_t(1u) << (x % 64u);
+    uint64_t& word = m_occupancy[y * m_words + x / 64u];
+
+    if (is) {
+      word |= bit;
+      ++m_rowTiles[y];
+      --m_empty;
+    }
+    else {
+      word &= ~bit;
+      --m_rowTiles[y];
+      ++m_empty;
+    }
+  }
+
+  void
+  Board::updateOccupancy() noexcept {
+    m_words = (m_width + 63u) / 64u;
+
+    m_occupancy.assign(m_height * m_words, 0u);
+    m_rowTiles.assign(m_height, 0u);
+    m_empty = m_width * m_height;
+
+    for (unsigned y = 0u ; y < m_height ; ++y) {
+      for (unsigned x = 0u ; x < m_width ; ++x) {
+        if (m_board[linear(x, y)] == 0u) {
+          continue;
+        }
+
+        m_occupancy[y * m_words + x / 64u] |= (uint64_t(1u) << (x % 64u));
+        ++m_rowTiles[y];
+        --m_empty;
+      }
+    }
+
+    // The dimensions of the board might have changed.
+    m_moves.assign(m_height, 0u);
+    m_movable.fill(0u);
+    m_dirtyRows.clear();
+    m_dirty.assign(m_height, false);
+
+    for (unsigned y = 0u ; y < m_height ; ++y) {
+      invalidateMoves(y);
+    }
+
+    updateMoves();
+  }
+
+  inline
+  void
+  Board::invalidateMoves(unsigned y) noexcept {
+    if (!m_dirty[y]) {
+      m_dirty[y] = true;
+      m_dirtyRows.push_back(y);
+    }
+  }
+
+  void
+  Board::updateMoves() noexcept {
+    for (unsigned id = 0u ; id < m_dirtyRows.size() ; ++id) {
+      unsigned y = m_dirtyRows[id];
+      uint8_t moves = rowMoves(y);
+
+      // Update the number of rows allowing each move with
+      // the moves which changed.
+      uint8_t changed = moves ^ m_moves[y];
+      for (unsigned m = 0u ; m < m_movable.size() ; ++m) {
+        if ((changed & (1u << m)) == 0u) {
+          continue;
+        }
+
+        if (moves & (1u << m)) {
+          ++m_movable[m];
+        }
+        else {
+          --m_movable[m];
+        }
+      }
+
+      m_moves[y] = moves;
+      m_dirty[y] = false;
+    }
+
+    m_dirtyRows.clear();
+  }
+
+  uint8_t
+  Board::rowMoves(unsigned y) const noexcept {
+    uint8_t moves = 0u;
+
+    // A tile can be moved when it has an empty space after
+    // it in the sense of the move, and two consecutive tiles
+    // with the same value can be merged in both senses. This
+    // is detected a word at a time from the occupancy of the
+    // rows: only adjacent tiles need to be compared.
+    if (m_rowTiles[y] > 0u) {
+      unsigned last = w() - 1u;
+
+      for (unsigned i = 0u ; i < m_words ; ++i) {
+        uint64_t occ = occupancy(y, i);
+
+        // The occupancy of the right and left neighbors of
+        // each cell of the word.
+        uint64_t right = (occ >> 1u) | (i + 1u < m_words ? occupancy(y, i + 1u) << 63u : 0u);
+        uint64_t left = (occ << 1u) | (i > 0u ? occupancy(y, i - 1u) >> 63u : 0u);
+
+        // Digits on the edge of the board can't move.
+        uint64_t toRight = occ & ~right;
+        if (last / 64u == i) {
+          toRight &= ~(uint64_t(1u) << (last % 64u));
+        }
+
+        uint64_t toLeft = occ & ~left;
+        if (i == 0u) {
+          toLeft &= ~uint64_t(1u);
+        }
+
+        if (toRight != 0u) {
+          moves |= moveFlag(true, true);
+        }
+        if (toLeft != 0u) {
+          moves |= moveFlag(true, false);
+        }
+        if (mergeable(y, i, occ & right, 1u, 0u)) {
+          moves |= moveFlag(true, true) | moveFlag(true, false);
+        }
+      }
+    }
+
+    // Vertical moves are detected by comparing the occupancy
+    // of this row with the next one.
+    if (y + 1u < h() && (m_rowTiles[y] > 0u || m_rowTiles[y + 1u] > 0u)) {
+      for (unsigned i = 0u ; i < m_words ; ++i) {
+        uint64_t top = occupancy(y, i);
+        uint64_t bottom = occupancy(y + 1u, i);
+
+        if ((bottom & ~top) != 0u) {
+          moves |= moveFlag(false, true);
+        }
+        if ((top & ~bottom) != 0u) {
+          moves |= moveFlag(false, false);
+        }
+        if (mergeable(y, i, top & bottom, 0u, 1u)) {
+          moves |= moveFlag(false, true) | moveFlag(false, false);
+        }
+      }
+    }
+
+    return moves;
+  }
+
+  inline
+  uint64_t
+  Board::occupancy(unsigned y, unsigned word) const noexcept {
+    return m_occupancy[y * m_words + word];
+  }
+
+  bool
+  Board::mergeable(unsigned y, unsigned word, uint64_t pairs, unsigned dx, unsigned dy) const noexcept {
+    while (pairs != 0u) {
+      unsigned x = word * 64u + static_cast<unsigned>(__builtin_ctzll(pairs));
+      pairs &= pairs - 1u;
+
+      if (m_board[linear(x, y)] == m_board[linear(x + dx, y + dy)]) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   inline
   unsigned
-  Board::collapseRow(unsigned y, bool positive) noexcept {
-    // Aggregate the elements of the row.
+  Board::collapseRow(unsigned y, bool positive, Trace* trace) noexcept {
+    // Aggregate the elements of the row along with their
+    // cells: only the occupied cells are visited.
     std::vector<unsigned> numbers;
-    for (unsigned x = 0u ; x < w() ; ++x) {
-      unsigned v = m_board[linear(x, y)];
+    std::vector<unsigned> cells;
+    for (unsigned i = 0u ; i < m_words ; ++i) {
+      uint64_t occ = occupancy(y, i);
 
-      if (v != 0u) {
-        numbers.push_back(v);
+      while (occ != 0u) {
+        unsigned x = i * 64u + static_cast<unsigned>(__builtin_ctzll(occ));
+        occ &= occ - 1u;
+
+        numbers.push_back(m_board[linear(x, y)]);
+        cells.push_back(linear(x, y));
       }
     }
 
@@ -371,6 +598,7 @@ namespace two48 {
     while (x < numbers.size()) {
       unsigned lid = (positive ? numbers.size() - 1u - x : x);
       unsigned lid2 = (positive ? numbers.size() - 1u - x - 1u : x + 1u);
+      bool merged = false;
 
       // In case we reached the last number, we can't
       // possible merge it.
@@ -385,31 +613,38 @@ namespace two48 {
         }
         else {
           out.push_back(numbers[lid] * 2u);
+          merged = true;
           ++x;
 
           // The score is the value of the new tile.
           score += (numbers[lid] * 2u);
         }
       }
+
+      // Record the motion of the tile(s) which ended up
+      // in the cell that was just filled.
+      if (trace != nullptr) {
+        uint16_t to = static_cast<uint16_t>(linear(positive ? w() - out.size() : out.size() - 1u, y));
+
+        trace->push_back(Slide{static_cast<uint16_t>(cells[lid]), to, merged, numbers[lid]});
+        if (merged) {
+          trace->push_back(Slide{static_cast<uint16_t>(cells[lid2]), to, true, numbers[lid2]});
+        }
+      }
       ++x;
     }
 
-    // Put elements in order at the top or bottom of the
-    // row as a result of the collapse.
-    unsigned id = 0u;
-    while (id < out.size()) {
-      unsigned x = positive ? w() - 1u - id : id;
-
-      m_board[linear(x, y)] = out[id];
-      ++id;
+    // Empty the cells which were occupied and put the
+    // elements in order at the top or bottom of the row
+    // as a result of the collapse.
+    for (unsigned id = 0u ; id < cells.size() ; ++id) {
+      setCell(cells[id] % w(), y, 0u);
     }
 
-    // Fill the rest with empty values.
-    while (id < w()) {
+    for (unsigned id = 0u ; id < out.size() ; ++id) {
       unsigned x = positive ? w() - 1u - id : id;
 
-      m_board[linear(x, y)] = 0u;
-      ++id;
+      setCell(x, y, out[id]);
     }
 
     return score;
@@ -417,14 +652,19 @@ namespace two48 {
 
   inline
   unsigned
-  Board::collapseColumn(unsigned x, bool positive) noexcept {
-    // Aggregate the elements of the column.
+  Board::collapseColumn(unsigned x, bool positive, Trace* trace) noexcept {
+    // Aggregate the elements of the column: when the
+    // move is traced we also keep track of their cells.
     std::vector<unsigned> numbers;
+    std::vector<unsigned> cells;
     for (unsigned y = 0u ; y < h() ; ++y) {
       unsigned v = m_board[linear(x, y)];
 
       if (v != 0u) {
         numbers.push_back(v);
+        if (trace != nullptr) {
+          cells.push_back(linear(x, y));
+        }
       }
     }
 
@@ -440,6 +680,7 @@ namespace two48 {
     while (y < numbers.size()) {
       unsigned lid = (positive ? y : numbers.size() - 1u - y);
       unsigned lid2 = (positive ? y + 1u : numbers.size() - 1u - y - 1u);
+      bool merged = false;
 
       // In case we reached the last number, we can't
       // possible merge it.
@@ -454,6 +695,7 @@ namespace two48 {
         }
         else {
           out.push_back(numbers[lid] * 2u);
+          merged = true;
           ++y;
 
           // The score is the value of the new tile.
@@ -461,6 +703,17 @@ namespace two48 {
         }
       }
 
+      // Record the motion of the tile(s) which ended up
+      // in the cell that was just filled.
+      if (trace != nullptr) {
+        uint16_t to = static_cast<uint16_t>(linear(x, positive ? out.size() - 1u : h() - out.size()));
+
+        trace->push_back(Slide{static_cast<uint16_t>(cells[lid]), to, merged, numbers[lid]});
+        if (merged) {
+          trace->push_back(Slide{static_cast<uint16_t>(cells[lid2]), to, true, numbers[lid2]});
+        }
+      }
+
       ++y;
     }
 
@@ -470,7 +723,7 @@ namespace two48 {
     while (id < out.size()) {
       unsigned y = positive ? id: h() - 1u - id;
 
-      m_board[linear(x, y)] = out[id];
+      setCell(x, y, out[id]);
       ++id;
     }
 
@@ -478,7 +731,7 @@ namespace two48 {
     while (id < h()) {
       unsigned y = positive ? id : h() - 1u - id;
 
-      m_board[linear(x, y)] = 0u;
+      setCell(x, y, 0u);
       ++id;
     }
 
@@ -1,13 +1,37 @@
 #ifndef    BOARD_HH
 # define   BOARD_HH
 
+# include <array>
 # include <vector>
 # include <memory>
 # include <deque>
+# include <cstdint>
 # include <core_utils/CoreObject.hh>
 
 namespace two48 {
 
+  /// @brief - Describes how a tile travelled during a move. Cells
+  /// are referenced through their linear index in the board (i.e.
+  /// `y * w + x`).
+  struct Slide {
+    // The cell of the tile before the move.
+    uint16_t from;
+
+    // The cell of the tile after the move.
+    uint16_t to;
+
+    // Whether the tile was merged with another one: in this case
+    // two slides end in the same cell.
+    bool merged;
+
+    // The value of the tile before the move.
+    unsigned value;
+  };
+
+  /// @brief - The motion of all the tiles of the board during a
+  /// move, including the ones which did not move.
+  using Trace = std::vector<Slide>;
+
   class Board: public utils::CoreObject {
     public:
 
@@ -55,6 +79,13 @@ namespace two48 {
       unsigned
       at(unsigned x, unsigned y) const;
 
+      /**
+       * @brief - The number of empty cells of the board.
+       * @return - the number of empty cells.
+       */
+      unsigned
+      emptyCells() const noexcept;
+
       /**
        * @brief - Check whether a horizontal move along the specified
        *          direction is possible or not: this is defined when
@@ -78,20 +109,25 @@ namespace two48 {
        *          which along the positive or negative axis based on
        *          the value of the input boolean.
        * @param positive - whether the move is towards positive x.
+       * @param trace - if not `null` receives the motion of each tile
+       *                during the move.
        * @return - the number of points brought by the move.
        */
       unsigned
-      moveHorizontally(bool positive);
+      moveHorizontally(bool positive, Trace* trace = nullptr);
 
       /**
        * @brief - Move the pieces in the board with a vertical move
        *          which along the positive or negative axis based on
        *          the value of the input boolean.
-       * @param positive - whether the move is towards positive y.
+       * @param positive - whether the move is towards `y = 0`, i.e.
+       *                   the top of the screen.
+       * @param trace - if not `null` receives the motion of each tile
+       *                during the move.
        * @return - the number of points brought by the move.
        */
       unsigned
-      moveVertically(bool positive);
+      moveVertically(bool positive, Trace* trace = nullptr);
 
       /**
        * @brief - Reset all tiles to be 0.
@@ -108,6 +144,18 @@ namespace two48 {
       bool
       spawn(unsigned value) noexcept;
 
+      /**
+       * @brief - Pop a tile with the input value at the specified
+       *          location in the grid.
+       * @param value - the value to spawn.
+       * @param x - the x coordinate of the tile.
+       * @param y - the y coordinate of the tile.
+       * @return - `true` in case the location is empty and the tile
+       *           could be spawned.
+       */
+      bool
+      spawn(unsigned value, unsigned x, unsigned y) noexcept;
+
       /**
        * @brief - Undo the last move if possible.
        */
@@ -149,25 +197,97 @@ namespace two48 {
       unsigned
       linear(unsigned x, unsigned y) const noexcept;
 
+      /**
+       * @brief - Define the value of a cell and keep the occupancy
+       *          of the board up to date.
+       * @param x - the x coordinate of the cell.
+       * @param y - the y coordinate of the cell.
+       * @param value - the new value of the cell.
+       */
+      void
+      setCell(unsigned x, unsigned y, unsigned value) noexcept;
+
+      /**
+       * @brief - Rebuild the occupancy of the board from its
+       *          content, e.g. after it was replaced wholesale.
+       *          The moves of all the rows are computed again.
+       */
+      void
+      updateOccupancy() noexcept;
+
+      /**
+       * @brief - Register that the moves possible in a row should
+       *          be computed again.
+       * @param y - the index of the row.
+       */
+      void
+      invalidateMoves(unsigned y) noexcept;
+
+      /**
+       * @brief - Compute again the moves possible in the rows which
+       *          changed since the last call.
+       */
+      void
+      updateMoves() noexcept;
+
+      /**
+       * @brief - Compute the moves possible in a row: horizontal
+       *          moves only depend on the row itself while vertical
+       *          moves are described for the pair formed by the row
+       *          and the next one.
+       * @param y - the index of the row.
+       * @return - the flags of the possible moves.
+       */
+      uint8_t
+      rowMoves(unsigned y) const noexcept;
+
+      /**
+       * @brief - The word of the occupancy of a row: bits beyond
+       *          the width of the board are always cleared.
+       * @param y - the index of the row.
+       * @param word - the index of the word in the row.
+       * @return - the occupancy of the cells of the word.
+       */
+      uint64_t
+      occupancy(unsigned y, unsigned word) const noexcept;
+
+      /**
+       * @brief - Whether two horizontally or vertically adjacent
+       *          tiles have the same value and can thus be merged.
+       * @param y - the index of the row of the first tiles.
+       * @param word - the index of the word of the tiles.
+       * @param pairs - the mask of the first tiles of the pairs
+       *                in this word.
+       * @param dx - the offset along the x axis of the second tile.
+       * @param dy - the offset along the y axis of the second tile.
+       * @return - `true` if at least one pair can be merged.
+       */
+      bool
+      mergeable(unsigned y, unsigned word, uint64_t pairs, unsigned dx, unsigned dy) const noexcept;
+
       /**
        * @brief - Move row horizontally in the specified direction.
        * @param y - the index of the row to process.
        * @param positive - whether the row should be collapsed towards
        *                   positive x or not.
+       * @param trace - if not `null` the motion of the tiles of the
+       *                row is appended to it.
        * @return - how much points the collapse brought.
        */
       unsigned
-      collapseRow(unsigned y, bool positive) noexcept;
+      collapseRow(unsigned y, bool positive, Trace* trace) noexcept;
 
       /**
        * @brief - Move column horizontally in the specified direction.
        * @param x - the index of the row to process.
-       * @param positive - whether the row should be collapsed towards
-       *                   positive y or not.
+       * @param positive - whether the column should be collapsed
+       *                   towards `y = 0` or not.
+       * @param trace - if not `null` the motion of the tiles of the
+       *                column is appended to it.
        * @return - how much points the collapse brought.
        */
       unsigned
-      collapseColumn(unsigned x, bool positive) noexcept;
+      collapseColumn(unsigned x, bool positive, Trace* trace) noexcept;
 
       /**
        * @brief - Save the current state of the board and handle the
@@ -193,6 +313,50 @@ namespace two48 {
        */
       mutable std::vector<unsigned> m_board;
 
+      /**
+       * @brief - The number of 64-bit words used to describe the
+       *          occupancy of a row.
+       */
+      unsigned m_words;
+
+      /**
+       * @brief - The occupancy of the board: each row is a bitmask
+       *          spread over `m_words` words where the bit `x` is
+       *          set when the cell is not empty. This allows to only
+       *          consider the occupied cells of large boards.
+       */
+      std::vector<uint64_t> m_occupancy;
+
+      /**
+       * @brief - The number of tiles in each row: empty rows can be
+       *          skipped altogether.
+       */
+      std::vector<unsigned> m_rowTiles;
+
+      /**
+       * @brief - The number of empty cells of the board.
+       */
+      unsigned m_empty;
+
+      /**
+       * @brief - The moves possible in each row, as computed by
+       *          the `rowMoves` method.
+       */
+      std::vector<uint8_t> m_moves;
+
+      /**
+       * @brief - The number of rows allowing each move: a move is
+       *          possible on the board as soon as one row allows it.
+       */
+      std::array<unsigned, 4u> m_movable;
+
+      /**
+       * @brief - The rows whose moves should be computed again and
+       *          whether each row is already part of this list.
+       */
+      std::vector<unsigned> m_dirtyRows;
+      std::vector<bool> m_dirty;
+
       /**
        * @brief - The depth of the undo stack.
        */
@@ -21,6 +21,28 @@
 /// @brief - The maximum height of the board.
 # define MAX_BOARD_HEIGHT 8
 
+/// @brief - The maximum width of the board in huge mode. Boards
+/// larger than `MAX_BOARD_WIDTH` are resized by powers of two.
+# define HUGE_BOARD_WIDTH 256
+
+/// @brief - The maximum height of the board in huge mode.
+# define HUGE_BOARD_HEIGHT 256
+
+/// @brief - The directory where solved tables are stored.
+# define SOLVED_TABLES_DIR "data/tables"
+
+/// @brief - The default duration in microseconds of the search
+/// performed at each frame in autoplay mode.
+# define AUTOPLAY_FRAME_BUDGET 4000u
+
+/// @brief - The number of nodes of the search explored at each
+/// frame in autoplay mode when the game is deterministic: this
+/// takes about as long as the default budget.
+# define AUTOPLAY_FRAME_NODES 12000u
+
+/// @brief - The depth of the search used in autoplay mode.
+# define AUTOPLAY_SEARCH_DEPTH 3u
+
 namespace {
 
   pge::MenuShPtr
@@ -74,9 +96,25 @@ namespace {
 
 }
 
+namespace {
+
+  unsigned
+  larger(unsigned dim, unsigned step, unsigned max) noexcept {
+    // Past the regular limit dimensions are doubled so that
+    // huge boards can be reached in a few steps.
+    return std::min(dim < step ? dim + 1u : 2u * dim, max);
+  }
+
+  unsigned
+  smaller(unsigned dim, unsigned step) noexcept {
+    return (dim > step ? std::max(dim / 2u, step) : std::max(dim - 1u, 2u));
+  }
+
+}
+
 namespace pge {
 
-  Game::Game():
+  Game::Game(bool huge):
     utils::CoreObject("game"),
 
     m_state(
@@ -88,15 +126,39 @@ namespace pge {
     ),
 
     m_menus(),
+    m_displayed(),
 
     m_width(BOARD_WIDTH),
     m_height(BOARD_HEIGHT),
+    m_maxWidth(huge ? HUGE_BOARD_WIDTH : MAX_BOARD_WIDTH),
+    m_maxHeight(huge ? HUGE_BOARD_HEIGHT : MAX_BOARD_HEIGHT),
     m_board(std::make_shared<two48::Game>(m_width, m_height, UNDO_STACK_DEPTH)),
+    m_revision(0u),
+    m_trace(),
+    m_traceRevision(0u),
     m_moves(0u),
     m_score(0u),
-    m_canMove(true)
+    m_canMove(true),
+
+    m_table(),
+    m_hint(two48::Direction::Count),
+    m_hintPending(false),
+    m_advisor(std::make_shared<two48::Advisor>()),
+
+    m_autoplay(false),
+    m_autoplayBudget(AUTOPLAY_FRAME_BUDGET),
+    m_search(AUTOPLAY_SEARCH_DEPTH),
+    m_searching(false),
+    m_deterministic(false)
   {
     setService("game");
+
+    m_trace.reserve(m_maxWidth * m_maxHeight);
+    // The initial board does not come from a move.
+    m_traceRevision = m_revision - 1u;
+
+    loadTable();
+    speculate();
   }
 
   Game::~Game() {}
@@ -108,6 +170,9 @@ namespace pge {
     olc::Pixel bg(250, 248, 239);
     olc::Pixel buttonBG(185, 172, 159);
 
+    // The new menus do not display anything yet.
+    m_displayed.valid = false;
+
     // Generate the status menu.
     MenuShPtr status = generateMenu(olc::vi2d(), olc::vi2d(width, STATUS_MENU_HEIGHT), "", "status", bg);
 
@@ -118,6 +183,8 @@ namespace pge {
     MenuShPtr sLabel = generateMenu(pos, dims, "Score:", "score_label", buttonBG);
     m_menus.score = generateMenu(pos, dims, "0", "score", buttonBG);
     m_menus.undo = generateMenu(pos, dims, "Undo", "unro", buttonBG, true);
+    m_menus.hint = generateMenu(pos, dims, "Hint", "hint", buttonBG, true);
+    m_menus.autoplay = generateMenu(pos, dims, "Auto", "autoplay", buttonBG, true);
     MenuShPtr reset = generateMenu(pos, dims, "Reset", "reset", buttonBG, true);
 
     m_menus.undo->setSimpleAction(
@@ -125,6 +192,16 @@ namespace pge {
         g.undo();
       }
     );
+    m_menus.hint->setSimpleAction(
+      [](Game& g) {
+        g.hint();
+      }
+    );
+    m_menus.autoplay->setSimpleAction(
+      [](Game& g) {
+        g.toggleAutoplay();
+      }
+    );
     reset->setSimpleAction(
       [](Game& g) {
         g.reset();
@@ -136,6 +213,8 @@ namespace pge {
     status->addMenu(sLabel);
     status->addMenu(m_menus.score);
     status->addMenu(m_menus.undo);
+    status->addMenu(m_menus.hint);
+    status->addMenu(m_menus.autoplay);
     status->addMenu(reset);
 
     // Generate the board dimensions menu.
@@ -149,38 +228,44 @@ namespace pge {
     m_menus.height = generateMenu(pos, dims, "0", "height", buttonBG);
     m_menus.hPlus = generateMenu(pos, dims, "+", "h_plus", buttonBG, true);
 
+    m_menus.adversarial = generateMenu(pos, dims, "Easy", "adversarial", buttonBG, true);
+
     mDims->addMenu(m_menus.wMinus);
     mDims->addMenu(m_menus.width);
     mDims->addMenu(m_menus.wPlus);
     mDims->addMenu(m_menus.hMinus);
     mDims->addMenu(m_menus.height);
     mDims->addMenu(m_menus.hPlus);
+    mDims->addMenu(m_menus.adversarial);
 
     m_menus.wMinus->setSimpleAction(
       [this](Game& g) {
-        unsigned w = (m_board->w() > 2u ? m_board->w() - 1u : m_board->w());
-        g.setBoardDimensions(w, m_board->h());
+        g.setBoardDimensions(smaller(m_board->w(), MAX_BOARD_WIDTH), m_board->h());
       }
     );
     m_menus.wPlus->setSimpleAction(
       [this](Game& g) {
-        g.setBoardDimensions(m_board->w() + 1u, m_board->h());
+        g.setBoardDimensions(larger(m_board->w(), MAX_BOARD_WIDTH, m_maxWidth), m_board->h());
       }
     );
     m_menus.hMinus->setSimpleAction(
       [this](Game& g) {
-        unsigned h = (m_board->h() > 2u ? m_board->h() - 1u : m_board->h());
-        g.setBoardDimensions(m_board->w(), h);
+        g.setBoardDimensions(m_board->w(), smaller(m_board->h(), MAX_BOARD_HEIGHT));
       }
     );
     m_menus.hPlus->setSimpleAction(
       [this](Game& g) {
-        g.setBoardDimensions(m_board->w(), m_board->h() + 1u);
+        g.setBoardDimensions(m_board->w(), larger(m_board->h(), MAX_BOARD_HEIGHT, m_maxHeight));
+      }
+    );
+    m_menus.adversarial->setSimpleAction(
+      [](Game& g) {
+        g.toggleAdversarial();
       }
     );
 
     // Generate the menu to indicate a loss.
-    m_menus.lost.date = utils::TimeStamp();
+    m_menus.lost.elapsed = 0.0f;
     m_menus.lost.wasActive = false;
     // We display the alert for 3 seconds.
     m_menus.lost.duration = 3000;
@@ -214,13 +299,23 @@ namespace pge {
   }
 
   bool
-  Game::step(float /*tDelta*/) {
+  Game::step(float tDelta) {
     // When the game is paused it is not over yet.
     if (m_state.paused) {
       return true;
     }
 
-    updateUI();
+    // Display the hint as soon as the advisor provides it.
+    if (m_hintPending && m_advisor->lookup(two48::PackedBoard(board()), m_hint)) {
+      m_hintPending = false;
+      checkHint();
+    }
+
+    if (m_autoplay && m_canMove) {
+      autoplay();
+    }
+
+    updateUI(tDelta);
 
     bool done = !m_canMove && !m_menus.lost.menu->visible();
     if (done) {
@@ -270,11 +365,11 @@ namespace pge {
     bool valid = false;
 
     if (x != 0) {
-      score = m_board->moveHorizontally(x > 0, valid);
+      score = m_board->moveHorizontally(x > 0, valid, &m_trace);
     }
 
     if (y != 0) {
-      score = m_board->moveVertically(y > 0, valid);
+      score = m_board->moveVertically(y > 0, valid, &m_trace);
     }
 
     // In case the move is not valid, do nothing.
@@ -295,6 +390,9 @@ namespace pge {
     }
 
     m_canMove = m_board->canMove();
+    ++m_revision;
+    m_traceRevision = m_revision;
+    speculate();
 
     // Update the moves and score.
     verbose("Move " + std::to_string(m_moves) + " brought " + std::to_string(score) + " point(s)");
@@ -315,6 +413,8 @@ namespace pge {
     info("Undoing last move");
 
     m_board->undo();
+    ++m_revision;
+    speculate();
   }
 
   void
@@ -324,8 +424,117 @@ namespace pge {
     // Reset variables.
     m_moves = 0u;
     m_score = 0u;
+
+    // The opponent can't analyze boards which are too large:
+    // tiles are then spawned at random.
+    bool adversarial = m_board->adversarial() && analyzable();
     m_board = std::make_shared<two48::Game>(m_width, m_height);
+    m_board->setAdversarial(adversarial);
+    m_board->setDeterministic(m_deterministic);
     m_canMove = true;
+    ++m_revision;
+
+    loadTable();
+    speculate();
+  }
+
+  void
+  Game::hint() {
+    // Do nothing while the game is paused.
+    if (m_state.paused) {
+      return;
+    }
+
+    if (!analyzable()) {
+      debug("Ignoring hint request for a board which can't be analyzed");
+      return;
+    }
+
+    two48::PackedBoard b(board());
+    two48::solver::Entry e;
+
+    if (!m_table.find(b, e) || e.move >= static_cast<uint8_t>(two48::Direction::Count)) {
+      // Fall back to the advisor: the move is probably
+      // already computed.
+      m_hintPending = !m_advisor->lookup(b, m_hint);
+      if (m_hintPending) {
+        debug("Waiting for the advisor to evaluate the current board");
+      }
+      else {
+        checkHint();
+      }
+
+      return;
+    }
+
+    m_hint = static_cast<two48::Direction>(e.move);
+    checkHint();
+    if (m_hint == two48::Direction::Count) {
+      return;
+    }
+
+    info(
+      "Best move is " + two48::toString(m_hint) + " with an expected score of " +
+      std::to_string(e.score) + " and a probability of " + std::to_string(e.win) +
+      " to reach " + std::to_string(m_table.target())
+    );
+  }
+
+  void
+  Game::toggleAutoplay() {
+    // Do nothing while the game is paused.
+    if (m_state.paused) {
+      return;
+    }
+
+    if (!m_autoplay && !analyzable()) {
+      debug("Ignoring autoplay request for a board which can't be analyzed");
+      return;
+    }
+
+    m_autoplay = !m_autoplay;
+    m_searching = false;
+
+    info(std::string(m_autoplay ? "Started" : "Stopped") + " autoplay");
+  }
+
+  void
+  Game::setAutoplayBudget(unsigned budget) noexcept {
+    m_autoplayBudget = budget;
+  }
+
+  void
+  Game::setDeterministic(bool deterministic) noexcept {
+    m_deterministic = deterministic;
+    m_board->setDeterministic(m_deterministic);
+    m_searching = false;
+  }
+
+  void
+  Game::toggleAdversarial() {
+    // Do nothing while the game is paused.
+    if (m_state.paused) {
+      return;
+    }
+
+    if (!m_board->adversarial() && !analyzable()) {
+      debug("Ignoring adversarial request for a board which can't be analyzed");
+      return;
+    }
+
+    m_board->setAdversarial(!m_board->adversarial());
+
+    info(std::string(m_board->adversarial() ? "Activated" : "Deactivated") + " adversarial spawns");
+  }
+
+  bool
+  Game::busy() const noexcept {
+    if (m_state.paused) {
+      return false;
+    }
+
+    bool lost = (m_menus.lost.menu != nullptr && m_menus.lost.menu->visible());
+    return m_hintPending || (m_autoplay && m_canMove) || lost;
   }
 
   const two48::Board&
@@ -361,6 +570,10 @@ namespace pge {
     m_height = m_board->h();
 
     m_canMove = m_board->canMove();
+    ++m_revision;
+
+    loadTable();
+    speculate();
 
     // Read the score and move count from the file: this is
     // written at the beginning of the file, after the header.
@@ -398,7 +611,44 @@ namespace pge {
   }
 
   void
-  Game::updateUI() {
+  Game::updateUI(float tDelta) {
+    // The menu indicating that the user lost is timed so
+    // it is updated at each frame.
+    m_menus.lost.update(!m_canMove, tDelta);
+
+    Displayed d{
+      true,                     // valid
+      m_moves,                  // moves
+      m_score,                  // score
+      m_board->canUndo(),       // canUndo
+      m_canMove,                // canMove
+      m_autoplay,               // autoplay
+      m_hint,                   // hint
+      m_hintPending,            // hintPending
+      m_width,                  // width
+      m_height,                 // height
+      m_board->adversarial()    // adversarial
+    };
+
+    bool changed =
+      !m_displayed.valid ||
+      d.moves != m_displayed.moves ||
+      d.score != m_displayed.score ||
+      d.canUndo != m_displayed.canUndo ||
+      d.canMove != m_displayed.canMove ||
+      d.autoplay != m_displayed.autoplay ||
+      d.hint != m_displayed.hint ||
+      d.hintPending != m_displayed.hintPending ||
+      d.width != m_displayed.width ||
+      d.height != m_displayed.height ||
+      d.adversarial != m_displayed.adversarial;
+
+    if (!changed) {
+      return;
+    }
+
+    m_displayed = d;
+
     // Update moves and score.
     m_menus.moves->setText(std::to_string(m_moves));
     m_menus.score->setText(std::to_string(m_score));
@@ -406,31 +656,178 @@ namespace pge {
     // Update the undo button.
     m_menus.undo->setEnabled(m_board->canUndo());
 
+    // Update the hint button: it is available as long as
+    // a move is possible.
+    std::string hint = (m_hint == two48::Direction::Count ? "Hint" : two48::toString(m_hint));
+    m_menus.hint->setText(m_hintPending ? "..." : hint);
+    m_menus.hint->setEnabled(m_canMove && !m_autoplay && analyzable());
+
+    m_menus.autoplay->setText(m_autoplay ? "Stop" : "Auto");
+    m_menus.autoplay->setEnabled(m_canMove && analyzable());
+
     // Update board dimensions.
     m_menus.width->setText(std::to_string(m_width));
     m_menus.height->setText(std::to_string(m_height));
 
     m_menus.wMinus->setEnabled(m_width > 2u);
-    m_menus.wPlus->setEnabled(m_width < MAX_BOARD_WIDTH);
+    m_menus.wPlus->setEnabled(m_width < m_maxWidth);
     m_menus.hMinus->setEnabled(m_height > 2u);
-    m_menus.hPlus->setEnabled(m_height < MAX_BOARD_HEIGHT);
+    m_menus.hPlus->setEnabled(m_height < m_maxHeight);
+
+    m_menus.adversarial->setText(m_board->adversarial() ? "Hard" : "Easy");
+    m_menus.adversarial->setEnabled(m_board->adversarial() || analyzable());
+  }
+
+  void
+  Game::loadTable() {
+    // Keep the current table if it matches the board.
+    if (m_table.matches(m_width, m_height)) {
+      return;
+    }
+
+    std::string file = std::string(SOLVED_TABLES_DIR) + "/" + std::to_string(m_width) + "x" + std::to_string(m_height) + ".tbl";
+
+    // Note that the previous table is released even if no
+    // table exists for the new dimensions.
+    m_table.load(file);
+  }
+
+  void
+  Game::speculate() {
+    m_hint = two48::Direction::Count;
+    m_hintPending = false;
+    m_searching = false;
+
+    // Boards too large to be analyzed can't be played
+    // automatically either.
+    if (!analyzable()) {
+      m_autoplay = false;
+      return;
+    }
 
-    // Update the menu indicating that the user lost.
-    m_menus.lost.update(!m_canMove);
+    if (m_canMove) {
+      m_advisor->speculate(two48::PackedBoard(board()));
+    }
+  }
+
+  bool
+  Game::analyzable() const noexcept {
+    return m_width <= two48::PackedBoard::MaxSize && m_height <= two48::PackedBoard::MaxSize;
   }
 
   bool
-  Game::TimedMenu::update(bool active) noexcept {
+  Game::legal(const two48::Direction& d) const noexcept {
+    const two48::Board& b = board();
+
+    switch (d) {
+      case two48::Direction::Left:
+        return b.canMoveHorizontally(false);
+      case two48::Direction::Right:
+        return b.canMoveHorizontally(true);
+      case two48::Direction::Down:
+        return b.canMoveVertically(false);
+      case two48::Direction::Up:
+        return b.canMoveVertically(true);
+      default:
+        return false;
+    }
+  }
+
+  void
+  Game::checkHint() {
+    if (m_hint == two48::Direction::Count || legal(m_hint)) {
+      return;
+    }
+
+    warn(
+      "Discarding hint " + two48::toString(m_hint),
+      "Move is not legal on the current board"
+    );
+    m_hint = two48::Direction::Count;
+  }
+
+  void
+  Game::autoplay() {
+    two48::PackedBoard b(board());
+    two48::Direction d = two48::Direction::Count;
+
+    // Use the exact move or the one computed by the advisor
+    // if available: otherwise continue the search. The time
+    // at which the advisor completes its evaluation depends
+    // on the load of the machine so it's not used when the
+    // game should be deterministic.
+    two48::solver::Entry e;
+    if (m_table.find(b, e) && e.move < static_cast<uint8_t>(two48::Direction::Count)) {
+      d = static_cast<two48::Direction>(e.move);
+    }
+    else if (m_deterministic || !m_advisor->lookup(b, d)) {
+      if (!m_searching) {
+        m_search.start(b);
+        m_searching = true;
+      }
+
+      bool done = (
+        m_deterministic ?
+        m_search.explore(AUTOPLAY_FRAME_NODES) :
+        m_search.resume(m_autoplayBudget)
+      );
+      if (!done) {
+        return;
+      }
+
+      d = m_search.move();
+    }
+
+    // A move rejected by the board would not trigger a new
+    // search: it would be picked again at each frame.
+    if (d != two48::Direction::Count && !legal(d)) {
+      warn(
+        "Stopping autoplay",
+        "Move " + two48::toString(d) + " is not legal on the current board"
+      );
+
+      m_autoplay = false;
+      m_searching = false;
+      return;
+    }
+
+    // Playing the move invalidates the search. Moving up
+    // collapses the tiles towards the top of the board.
+    switch (d) {
+      case two48::Direction::Left:
+        move(-1, 0);
+        break;
+      case two48::Direction::Right:
+        move(1, 0);
+        break;
+      case two48::Direction::Down:
+        move(0, -1);
+        break;
+      case two48::Direction::Up:
+        move(0, 1);
+        break;
+      default:
+        m_searching = false;
+        break;
+    }
+  }
+
+  bool
+  Game::TimedMenu::update(bool active, float tDelta) noexcept {
     // In case the menu should be active.
     if (active) {
       if (!wasActive) {
         // Make it active if it's the first time that
         // we detect that it should be active.
-        date = utils::now();
+        elapsed = 0.0f;
         wasActive = true;
         menu->setVisible(true);
       }
-      else if (utils::now() > date + utils::toMilliseconds(duration)) {
+      else {
+        elapsed += tDelta * 1000.0f;
+      }
+
+      if (elapsed > duration) {
         // Deactivate the menu in case it's been active
         // for too long.
         menu->setVisible(false);
@@ -440,7 +837,7 @@ namespace pge {
         // for not long enough.
         olc::Pixel c = menu->getBackgroundColor();
 
-        float d = utils::diffInMs(date, utils::now()) / duration;
+        float d = elapsed / duration;
         c.a = static_cast<uint8_t>(
           std::clamp((1.0f - d) * pge::alpha::Opaque, 0.0f, 255.0f)
         );
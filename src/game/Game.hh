@@ -4,8 +4,10 @@
 # include <vector>
 # include <memory>
 # include <core_utils/CoreObject.hh>
-# include <core_utils/TimeUtils.hh>
 # include "2048.hh"
+# include "SolvedTable.hh"
+# include "Advisor.hh"
+# include "Search.hh"
 
 namespace pge {
 
@@ -19,8 +21,13 @@ namespace pge {
 
       /**
        * @brief - Create a new game with default parameters.
+       * @param huge - whether the dimensions of the board can be
+       *               increased up to `256x256`. Boards larger
+       *               than `8x8` can't be analyzed so hints and
+       *               autoplay are not available for them.
        */
-      Game();
+      explicit
+      Game(bool huge = false);
 
       ~Game();
 
@@ -132,6 +139,55 @@ namespace pge {
       void
       reset();
 
+      /**
+       * @brief - Compute the best move for the current board. It
+       *          is exact if a solved table is available for its
+       *          dimensions, and otherwise fetched from the moves
+       *          computed in the background by the advisor: if the
+       *          move is not ready yet, it is displayed as soon as
+       *          it becomes available. The hint is displayed until
+       *          the next move.
+       */
+      void
+      hint();
+
+      /**
+       * @brief - Start or stop the autoplay mode. In this mode the
+       *          game plays by itself: the best move is searched at
+       *          each frame for a limited amount of time so that the
+       *          application stays responsive.
+       */
+      void
+      toggleAutoplay();
+
+      /**
+       * @brief - Define the maximum duration spent searching for the
+       *          next move at each frame in autoplay mode.
+       * @param budget - the duration in microseconds.
+       */
+      void
+      setAutoplayBudget(unsigned budget) noexcept;
+
+      /**
+       * @brief - Define whether the game should only depend on the
+       *          inputs and the duration of the frames, e.g. when
+       *          the session is recorded or replayed: the searches
+       *          are then limited to a number of nodes rather than
+       *          to a duration and the moves computed in background
+       *          by the advisor are not used by the autoplay.
+       * @param deterministic - `true` to make the game deterministic.
+       */
+      void
+      setDeterministic(bool deterministic) noexcept;
+
+      /**
+       * @brief - Switch between tiles spawned at random and tiles
+       *          spawned by an adversarial opponent. The mode is
+       *          kept when the game is reset.
+       */
+      void
+      toggleAdversarial();
+
       /**
        * @brief - Returns the board attached to this game.
        * @return - the board attached to this game.
@@ -139,6 +195,36 @@ namespace pge {
       const two48::Board&
       board() const noexcept;
 
+      /**
+       * @brief - Returns a counter incremented each time the board
+       *          changes (move, undo, reset, etc.). It allows the
+       *          renderer to detect whether the board needs to be
+       *          drawn again.
+       * @return - the revision of the board.
+       */
+      unsigned
+      revision() const noexcept;
+
+      /**
+       * @brief - The motion of the tiles during the last move. It
+       *          is only available right after the move: if the
+       *          board changed in another way since then (undo,
+       *          reset, etc.) nothing is returned.
+       * @return - the trace of the last move or `null`.
+       */
+      const two48::Trace*
+      trace() const noexcept;
+
+      /**
+       * @brief - Whether the game needs to be stepped even though
+       *          nothing changed on screen: this is the case when
+       *          waiting for a hint, during the autoplay mode or
+       *          while a timed menu is displayed.
+       * @return - `true` if the game is busy.
+       */
+      bool
+      busy() const noexcept;
+
       /**
        * @brief - Used to update the dimensions of the board to
        *          the specified value. If the dimensions are the
@@ -179,18 +265,69 @@ namespace pge {
       /**
        * @brief - Used during the step function and by any process
        *          that needs to update the UI and the text content
-       *          of menus.
+       *          of menus. Menus are only updated when the values
+       *          they display changed.
        */
       virtual void
-      updateUI();
+      updateUI(float tDelta);
+
+      /**
+       * @brief - Load the solved table matching the dimensions of
+       *          the board if it exists. This allows to provide a
+       *          perfect hint on small boards.
+       */
+      void
+      loadTable();
+
+      /**
+       * @brief - Notify the advisor that a new board was reached
+       *          so that it can start evaluating it. Also clears
+       *          the hint of the previous board.
+       */
+      void
+      speculate();
+
+      /**
+       * @brief - Whether the board is small enough to be analyzed
+       *          by the search and the solved tables: otherwise no
+       *          hint can be provided.
+       * @return - `true` if the board can be analyzed.
+       */
+      bool
+      analyzable() const noexcept;
+
+      /**
+       * @brief - Whether the move in the input direction is legal
+       *          on the current board, i.e. at least a tile would
+       *          move.
+       * @param d - the direction of the move.
+       * @return - `true` if the move is legal.
+       */
+      bool
+      legal(const two48::Direction& d) const noexcept;
+
+      /**
+       * @brief - Discard the current hint in case it is not a legal
+       *          move on the board: this would mean that the tables
+       *          or the search disagree with the rules of the game.
+       */
+      void
+      checkHint();
+
+      /**
+       * @brief - Perform a slice of the search for the next move in
+       *          autoplay mode and play it when it is found.
+       */
+      void
+      autoplay();
 
     private:
 
       /// @brief - Convenience structure allowing to group information
       /// about a timed menu.
       struct TimedMenu {
-        // Information about when the menu started appearing.
-        utils::TimeStamp date;
+        // The time in milliseconds since the menu appeared.
+        float elapsed;
 
         // Keep track of whether the menu was already active.
         bool wasActive;
@@ -198,7 +335,7 @@ namespace pge {
         // The alert menu indicating controlled by this object.
         MenuShPtr menu;
 
-        // The duration of the alert.
+        // The duration of the alert in milliseconds.
         int duration;
 
         /**
@@ -207,10 +344,12 @@ namespace pge {
          *          be active or not.
          * @param active - `true` if the menu should still be
          *                 active.
+         * @param tDelta - the duration of the last frame in
+         *                 seconds.
          * @return - `true` if the menu is still visible.
          */
         bool
-        update(bool active) noexcept;
+        update(bool active, float tDelta) noexcept;
       };
 
       /// @brief - Convenience information defining the state of the
@@ -263,13 +402,48 @@ namespace pge {
         // The menu to increase the height of the board.
         MenuShPtr hPlus;
 
+        // The menu toggling the adversarial spawns.
+        MenuShPtr adversarial;
+
         // The menu displaying the undo action.
         MenuShPtr undo;
 
+        // The menu displaying the hint action.
+        MenuShPtr hint;
+
+        // The menu toggling the autoplay mode.
+        MenuShPtr autoplay;
+
         // The menu displaying when the user lost.
         TimedMenu lost;
       };
 
+      /// @brief - The values displayed by the menus when they were
+      /// last updated: the menus are only updated when one of these
+      /// values changes.
+      struct Displayed {
+        // Whether the menus were updated since they were created.
+        bool valid;
+
+        // The statistics of the game.
+        unsigned moves;
+        unsigned score;
+
+        // The state of the actions.
+        bool canUndo;
+        bool canMove;
+        bool autoplay;
+
+        // The hint for the current board.
+        two48::Direction hint;
+        bool hintPending;
+
+        // The settings of the board.
+        unsigned width;
+        unsigned height;
+        bool adversarial;
+      };
+
       /**
        * @brief - The definition of the game state.
        */
@@ -281,6 +455,11 @@ namespace pge {
        */
       Menus m_menus;
 
+      /**
+       * @brief - The values displayed by the menus.
+       */
+      Displayed m_displayed;
+
       /**
        * @brief - The width of the board in cells.
        */
@@ -291,11 +470,31 @@ namespace pge {
        */
       unsigned m_height;
 
+      /**
+       * @brief - The maximum dimensions of the board in cells.
+       */
+      unsigned m_maxWidth;
+      unsigned m_maxHeight;
+
       /**
        * @brief - The board managed by this game.
        */
       two48::GameShPtr m_board;
 
+      /**
+       * @brief - The revision of the board, incremented each time
+       *          its content changes.
+       */
+      unsigned m_revision;
+
+      /**
+       * @brief - The motion of the tiles during the last move and
+       *          the revision of the board that it produced. The
+       *          buffer is reused from one move to the next.
+       */
+      two48::Trace m_trace;
+      unsigned m_traceRevision;
+
       /**
        * @brief - The number of moves played by the user.
        */
@@ -310,6 +509,60 @@ namespace pge {
        * @brief - Whether at least a move is possible for the user.
        */
       bool m_canMove;
+
+      /**
+       * @brief - The table of solved positions for the dimensions
+       *          of the board, if any is available.
+       */
+      two48::SolvedTable m_table;
+
+      /**
+       * @brief - The best move for the current board as computed
+       *          by the last hint request: `Count` if no hint has
+       *          been requested since the last move.
+       */
+      two48::Direction m_hint;
+
+      /**
+       * @brief - Whether a hint was requested but is not computed
+       *          yet by the advisor.
+       */
+      bool m_hintPending;
+
+      /**
+       * @brief - Computes the best moves in the background for the
+       *          boards reached in the game.
+       */
+      two48::AdvisorShPtr m_advisor;
+
+      /**
+       * @brief - Whether the game plays by itself.
+       */
+      bool m_autoplay;
+
+      /**
+       * @brief - The maximum duration in microseconds spent in the
+       *          search of the next move at each frame.
+       */
+      unsigned m_autoplayBudget;
+
+      /**
+       * @brief - The search used in autoplay mode: it is resumed at
+       *          each frame until it reaches its full depth.
+       */
+      two48::Search m_search;
+
+      /**
+       * @brief - Whether the search was started for the current
+       *          board.
+       */
+      bool m_searching;
+
+      /**
+       * @brief - Whether the game should only depend on the inputs
+       *          and the duration of the frames.
+       */
+      bool m_deterministic;
   };
 
   using GameShPtr = std::shared_ptr<Game>;
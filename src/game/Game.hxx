@@ -18,6 +18,18 @@ namespace pge {
     return m_state.terminated;
   }
 
+  inline
+  unsigned
+  Game::revision() const noexcept {
+    return m_revision;
+  }
+
+  inline
+  const two48::Trace*
+  Game::trace() const noexcept {
+    return (m_traceRevision == m_revision ? &m_trace : nullptr);
+  }
+
   inline
   void
   Game::pause() {
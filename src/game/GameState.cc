@@ -122,6 +122,16 @@ namespace pge {
     m_gameOver->render(pge);
   }
 
+  bool
+  GameState::consumeChanges() noexcept {
+    // Make sure that all the screens are consumed.
+    bool changed = m_home->consumeChanges();
+    changed = m_loadGame->consumeChanges() || changed;
+    changed = m_gameOver->consumeChanges() || changed;
+
+    return changed;
+  }
+
   menu::InputHandle
   GameState::processUserInput(const controls::State& c,
                               std::vector<ActionShPtr>& actions)
@@ -64,6 +64,16 @@ namespace pge {
       void
       render(olc::PixelGameEngine* pge) const;
 
+      /**
+       * @brief - Whether any of the screens changed since the last
+       *          call to this method. Changing the active screen
+       *          updates the visibility of the screens so it is
+       *          also reported.
+       * @return - `true` if the screens should be rendered again.
+       */
+      bool
+      consumeChanges() noexcept;
+
       /**
        * @brief - Performs the interpretation of the controls
        *          provided as input to update the selected
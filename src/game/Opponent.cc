@@ -0,0 +1,177 @@
+
+# include "Opponent.hh"
+# include <limits>
+# include "Search.hh"
+
+/// @brief - The number of nodes visited between two checks of
+/// the time spent in the search.
+# define NODES_PER_TIME_CHECK 32u
+
+namespace two48 {
+
+  Opponent::Opponent(unsigned depth,
+                     float budget) noexcept:
+    m_depth(std::max(depth, 1u)),
+    m_budget(budget),
+    m_nodeBudget(0u),
+
+    m_start(),
+    m_nodes(0u),
+    m_visited(0u),
+    m_expired(false)
+  {}
+
+  bool
+  Opponent::spawn(const PackedBoard& board,
+                  unsigned& x,
+                  unsigned& y,
+                  unsigned& value)
+  {
+    if (board.empty() == 0u) {
+      return false;
+    }
+
+    m_start = utils::now();
+    m_nodes = 0u;
+    m_visited = 0u;
+    m_expired = false;
+
+    // The best spawn of the deepest complete iteration:
+    // the first iteration might not complete on a large
+    // board so we keep the best spawn found in it.
+    unsigned bestCell = 0u, bestExp = 0u;
+    bool found = false;
+
+    for (unsigned depth = 1u ; depth <= m_depth && !m_expired ; ++depth) {
+      float beta = std::numeric_limits<float>::max();
+      unsigned cell = 0u, exp = 0u;
+      bool valid = false;
+
+      for (unsigned c = 0u ; c < board.w() * board.h() && !m_expired ; ++c) {
+        unsigned cx = c % board.w(), cy = c / board.w();
+        if (board.exponent(cx, cy) != 0u) {
+          continue;
+        }
+
+        for (unsigned e = 1u ; e <= 2u && !m_expired ; ++e) {
+          PackedBoard s = board;
+          s.set(cx, cy, e);
+
+          float v = maximize(s, depth - 1u, std::numeric_limits<float>::lowest(), beta);
+          if (m_expired) {
+            break;
+          }
+
+          if (!valid || v < beta) {
+            beta = v;
+            cell = c;
+            exp = e;
+            valid = true;
+          }
+        }
+      }
+
+      // Discard interrupted iterations unless nothing else
+      // is available.
+      if (valid && (!m_expired || !found)) {
+        bestCell = cell;
+        bestExp = exp;
+        found = true;
+      }
+    }
+
+    // Fall back to the first empty cell if the budget is too
+    // small to evaluate a single spawn.
+    if (!found) {
+      while (board.exponent(bestCell % board.w(), bestCell / board.w()) != 0u) {
+        ++bestCell;
+      }
+      bestExp = 1u;
+    }
+
+    x = bestCell % board.w();
+    y = bestCell / board.w();
+    value = 1u << bestExp;
+
+    return true;
+  }
+
+  void
+  Opponent::setNodeBudget(unsigned nodes) noexcept {
+    m_nodeBudget = nodes;
+  }
+
+  float
+  Opponent::minimize(const PackedBoard& board, unsigned depth, float alpha, float beta) {
+    for (unsigned y = 0u ; y < board.h() ; ++y) {
+      for (unsigned x = 0u ; x < board.w() ; ++x) {
+        if (board.exponent(x, y) != 0u) {
+          continue;
+        }
+
+        for (unsigned e = 1u ; e <= 2u ; ++e) {
+          PackedBoard s = board;
+          s.set(x, y, e);
+
+          beta = std::min(beta, maximize(s, depth, alpha, beta));
+          if (beta <= alpha || m_expired) {
+            return beta;
+          }
+        }
+      }
+    }
+
+    return beta;
+  }
+
+  float
+  Opponent::maximize(const PackedBoard& board, unsigned depth, float alpha, float beta) {
+    if (expired()) {
+      return alpha;
+    }
+
+    // A lost game is the worst outcome for the player.
+    float best = 0.0f;
+    bool moved = false;
+
+    for (unsigned d = 0u ; d < static_cast<unsigned>(Direction::Count) ; ++d) {
+      PackedBoard b = board;
+      unsigned points = 0u;
+      if (!b.move(static_cast<Direction>(d), points)) {
+        continue;
+      }
+
+      float a = (moved ? std::max(alpha, best) : alpha);
+      float v = (depth == 0u ? Search::heuristic(b) : minimize(b, depth - 1u, a, beta));
+      best = (moved ? std::max(best, v) : v);
+      moved = true;
+
+      if (best >= beta || m_expired) {
+        break;
+      }
+    }
+
+    return best;
+  }
+
+  bool
+  Opponent::expired() noexcept {
+    if (m_nodeBudget > 0u) {
+      ++m_visited;
+      m_expired = m_expired || m_visited >= m_nodeBudget;
+
+      return m_expired;
+    }
+
+    ++m_nodes;
+    if (m_nodes < NODES_PER_TIME_CHECK) {
+      return m_expired;
+    }
+
+    m_nodes = 0u;
+    m_expired = m_expired || utils::diffInMs(m_start, utils::now()) * 1000.0f >= m_budget;
+
+    return m_expired;
+  }
+
+}
@@ -0,0 +1,139 @@
+#ifndef    OPPONENT_HH
+# define   OPPONENT_HH
+
+# include <memory>
+# include <core_utils/TimeUtils.hh>
+# include "PackedBoard.hh"
+
+namespace two48 {
+
+  /// @brief - Adversarial spawn policy: rather than spawning tiles
+  /// at random, the opponent picks the location and the value that
+  /// minimize the prospects of the player. This is evaluated with
+  /// a depth-limited minimax search with alpha-beta pruning where
+  /// the player maximizes the heuristic of the `Search` class.
+  /// The search proceeds by increasing depth and is stopped when
+  /// its time budget is exhausted: the result of the deepest full
+  /// iteration is used.
+  /// The budget is a soft target: the clock is checked every few
+  /// nodes, including within an iteration, but the latency of a
+  /// spawn can still exceed it, e.g. when the thread is preempted.
+  /// The search can instead be limited to a number of nodes: the
+  /// spawns then only depend on the board, e.g. to replay a game.
+  class Opponent {
+    public:
+
+      /**
+       * @brief - Create a new opponent.
+       * @param depth - the maximum number of spawns explored.
+       * @param budget - the target duration of the search for a
+       *                 spawn in microseconds.
+       */
+      Opponent(unsigned depth = 4u,
+               float budget = 2000.0f) noexcept;
+
+      /**
+       * @brief - Compute the worst spawn for the player on the
+       *          input board.
+       * @param board - the board after the move of the player.
+       * @param x - output argument receiving the x coordinate of
+       *            the spawned tile.
+       * @param y - output argument receiving the y coordinate of
+       *            the spawned tile.
+       * @param value - output argument receiving the value of the
+       *                spawned tile.
+       * @return - `false` if the board is full.
+       */
+      bool
+      spawn(const PackedBoard& board,
+            unsigned& x,
+            unsigned& y,
+            unsigned& value);
+
+      /**
+       * @brief - Limit the search to a number of nodes rather than
+       *          to its time budget.
+       * @param nodes - the maximum number of nodes visited for a
+       *                spawn, `0` to use the time budget.
+       */
+      void
+      setNodeBudget(unsigned nodes) noexcept;
+
+    private:
+
+      /**
+       * @brief - Evaluate a board where the opponent should spawn
+       *          a tile.
+       * @param board - the board to evaluate.
+       * @param depth - the remaining spawns to explore.
+       * @param alpha - the value guaranteed to the player.
+       * @param beta - the value guaranteed to the opponent.
+       * @return - the value of the worst spawn for the player.
+       */
+      float
+      minimize(const PackedBoard& board, unsigned depth, float alpha, float beta);
+
+      /**
+       * @brief - Evaluate a board where the player should move.
+       * @param board - the board to evaluate.
+       * @param depth - the remaining spawns to explore.
+       * @param alpha - the value guaranteed to the player.
+       * @param beta - the value guaranteed to the opponent.
+       * @return - the value of the best move for the player.
+       */
+      float
+      maximize(const PackedBoard& board, unsigned depth, float alpha, float beta);
+
+      /**
+       * @brief - Whether the budget of the search is exceeded. The
+       *          clock is only checked every few nodes.
+       * @return - `true` if the search should stop.
+       */
+      bool
+      expired() noexcept;
+
+    private:
+
+      /**
+       * @brief - The maximum depth of the search.
+       */
+      unsigned m_depth;
+
+      /**
+       * @brief - The time budget of the search in microseconds.
+       */
+      float m_budget;
+
+      /**
+       * @brief - The maximum number of nodes visited by a search,
+       *          `0` if it is limited by its time budget.
+       */
+      unsigned m_nodeBudget;
+
+      /**
+       * @brief - The time at which the current search started.
+       */
+      utils::TimeStamp m_start;
+
+      /**
+       * @brief - The number of nodes visited since the last check
+       *          of the time budget.
+       */
+      unsigned m_nodes;
+
+      /**
+       * @brief - The number of nodes visited by the current search.
+       */
+      unsigned m_visited;
+
+      /**
+       * @brief - Whether the current search ran out of budget: its
+       *          results should be discarded.
+       */
+      bool m_expired;
+  };
+
+  using OpponentShPtr = std::shared_ptr<Opponent>;
+}
+
+#endif    /* OPPONENT_HH */
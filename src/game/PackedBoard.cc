@@ -0,0 +1,294 @@
+
+# include "PackedBoard.hh"
+
+namespace two48 {
+
+  PackedBoard::PackedBoard(unsigned width,
+                           unsigned height) noexcept:
+    m_width(std::min(width, MaxSize)),
+    m_height(std::min(height, MaxSize)),
+
+    m_rows()
+  {
+    m_rows.fill(0u);
+  }
+
+  PackedBoard::PackedBoard(const Board& board) noexcept:
+    PackedBoard(board.w(), board.h())
+  {
+    for (unsigned y = 0u ; y < h() ; ++y) {
+      for (unsigned x = 0u ; x < w() ; ++x) {
+        set(x, y, exponentOf(board.at(x, y)));
+      }
+    }
+  }
+
+  PackedBoard
+  PackedBoard::fromKey(Key key, unsigned width, unsigned height) noexcept {
+    PackedBoard b(std::min(width, 4u), std::min(height, 4u));
+
+    for (unsigned y = 0u ; y < b.h() ; ++y) {
+      b.m_rows[y] = static_cast<uint32_t>((key >> (16u * y)) & 0xFFFFu);
+    }
+
+    return b;
+  }
+
+  unsigned
+  PackedBoard::empty() const noexcept {
+    unsigned count = 0u;
+
+    for (unsigned y = 0u ; y < h() ; ++y) {
+      for (unsigned x = 0u ; x < w() ; ++x) {
+        if (exponent(x, y) == 0u) {
+          ++count;
+        }
+      }
+    }
+
+    return count;
+  }
+
+  unsigned
+  PackedBoard::maxExponent() const noexcept {
+    unsigned e = 0u;
+
+    for (unsigned y = 0u ; y < h() ; ++y) {
+      for (unsigned x = 0u ; x < w() ; ++x) {
+        e = std::max(e, exponent(x, y));
+      }
+    }
+
+    return e;
+  }
+
+  unsigned
+  PackedBoard::sum() const noexcept {
+    unsigned s = 0u;
+
+    for (unsigned y = 0u ; y < h() ; ++y) {
+      for (unsigned x = 0u ; x < w() ; ++x) {
+        s += at(x, y);
+      }
+    }
+
+    return s;
+  }
+
+  bool
+  PackedBoard::move(const Direction& d, unsigned& score) noexcept {
+    std::array<uint32_t, MaxSize> before = m_rows;
+    score = 0u;
+
+    switch (d) {
+      case Direction::Left:
+      case Direction::Right:
+        for (unsigned y = 0u ; y < h() ; ++y) {
+          collapseRow(y, d == Direction::Right, score);
+        }
+        break;
+      case Direction::Down:
+      case Direction::Up:
+      default:
+        for (unsigned x = 0u ; x < w() ; ++x) {
+          collapseColumn(x, d == Direction::Down, score);
+        }
+        break;
+    }
+
+    return before != m_rows;
+  }
+
+  bool
+  PackedBoard::canMove(const Direction& d) const noexcept {
+    // A move is possible when two consecutive tiles have
+    // the same value or when a tile is followed by an
+    // empty cell in the direction of the move.
+    bool horizontal = (d == Direction::Left || d == Direction::Right);
+    bool positive = (d == Direction::Right || d == Direction::Down);
+
+    unsigned lines = (horizontal ? h() : w());
+    unsigned cells = (horizontal ? w() : h());
+
+    for (unsigned l = 0u ; l < lines ; ++l) {
+      unsigned prev = exponent(
+        horizontal ? (positive ? 0u : cells - 1u) : l,
+        horizontal ? l : (positive ? 0u : cells - 1u)
+      );
+
+      for (unsigned c = 1u ; c < cells ; ++c) {
+        unsigned id = (positive ? c : cells - 1u - c);
+        unsigned cur = (horizontal ? exponent(id, l) : exponent(l, id));
+
+        if (prev != 0u && (cur == 0u || cur == prev)) {
+          return true;
+        }
+
+        prev = cur;
+      }
+    }
+
+    return false;
+  }
+
+  void
+  PackedBoard::collapseRow(unsigned y, bool positive, unsigned& score) noexcept {
+    // Gather the tiles in the order in which they will be
+    // merged: starting from the side towards which the row
+    // is collapsed.
+    std::array<unsigned, MaxSize> out;
+    unsigned count = 0u;
+    unsigned pending = 0u;
+
+    for (unsigned c = 0u ; c < w() ; ++c) {
+      unsigned e = exponent(positive ? w() - 1u - c : c, y);
+      if (e == 0u) {
+        continue;
+      }
+
+      if (pending == e) {
+        // Merge with the previous tile.
+        out[count - 1u] = std::min(e + 1u, MaxExponent);
+        score += (1u << (e + 1u));
+        pending = 0u;
+      }
+      else {
+        out[count] = e;
+        ++count;
+        pending = e;
+      }
+    }
+
+    m_rows[y] = 0u;
+    for (unsigned c = 0u ; c < count ; ++c) {
+      set(positive ? w() - 1u - c : c, y, out[c]);
+    }
+  }
+
+  void
+  PackedBoard::collapseColumn(unsigned x, bool positive, unsigned& score) noexcept {
+    std::array<unsigned, MaxSize> out;
+    unsigned count = 0u;
+    unsigned pending = 0u;
+
+    for (unsigned c = 0u ; c < h() ; ++c) {
+      unsigned e = exponent(x, positive ? h() - 1u - c : c);
+      if (e == 0u) {
+        continue;
+      }
+
+      if (pending == e) {
+        out[count - 1u] = std::min(e + 1u, MaxExponent);
+        score += (1u << (e + 1u));
+        pending = 0u;
+      }
+      else {
+        out[count] = e;
+        ++count;
+        pending = e;
+      }
+    }
+
+    for (unsigned c = 0u ; c < h() ; ++c) {
+      set(x, positive ? h() - 1u - c : c, c < count ? out[c] : 0u);
+    }
+  }
+
+  PackedBoard
+  PackedBoard::canonical(Symmetry* s) const noexcept {
+    // Only square boards can be transposed: otherwise the
+    // dimensions of the board would change.
+    unsigned count = (m_width == m_height ? 8u : 4u);
+
+    PackedBoard best = *this;
+    Symmetry bestS{false, false, false};
+
+    // The order of the images is irrelevant as long as it is
+    // total: we compare the packed rows directly.
+    for (unsigned id = 1u ; id < count ; ++id) {
+      Symmetry sym{id >= 4u, (id & 1u) != 0u, (id & 2u) != 0u};
+
+      PackedBoard cur = transformed(sym);
+      if (cur.m_rows < best.m_rows) {
+        best = cur;
+        bestS = sym;
+      }
+    }
+
+    if (s != nullptr) {
+      *s = bestS;
+    }
+
+    return best;
+  }
+
+  Direction
+  transform(const Direction& d, const Symmetry& s) noexcept {
+    Direction out = d;
+
+    // Apply the operations in the same order as for the
+    // boards.
+    if (s.transpose) {
+      switch (out) {
+        case Direction::Left:
+          out = Direction::Up;
+          break;
+        case Direction::Right:
+          out = Direction::Down;
+          break;
+        case Direction::Down:
+          out = Direction::Right;
+          break;
+        case Direction::Up:
+          out = Direction::Left;
+          break;
+        default:
+          break;
+      }
+    }
+    if (s.mirrorX && (out == Direction::Left || out == Direction::Right)) {
+      out = (out == Direction::Left ? Direction::Right : Direction::Left);
+    }
+    if (s.mirrorY && (out == Direction::Down || out == Direction::Up)) {
+      out = (out == Direction::Down ? Direction::Up : Direction::Down);
+    }
+
+    return out;
+  }
+
+  Direction
+  restore(const Direction& d, const Symmetry& s) noexcept {
+    // Each operation is its own inverse: we just need to
+    // apply them in the reverse order.
+    Direction out = d;
+
+    if (s.mirrorY) {
+      out = transform(out, Symmetry{false, false, true});
+    }
+    if (s.mirrorX) {
+      out = transform(out, Symmetry{false, true, false});
+    }
+    if (s.transpose) {
+      out = transform(out, Symmetry{true, false, false});
+    }
+
+    return out;
+  }
+
+  std::string
+  toString(const Direction& d) noexcept {
+    switch (d) {
+      case Direction::Left:
+        return "left";
+      case Direction::Right:
+        return "right";
+      case Direction::Down:
+        return "down";
+      case Direction::Up:
+        return "up";
+      default:
+        return "unknown";
+    }
+  }
+
+}
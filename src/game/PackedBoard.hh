@@ -0,0 +1,338 @@
+#ifndef    PACKED_BOARD_HH
+# define   PACKED_BOARD_HH
+
+# include <array>
+# include <string>
+# include <cstdint>
+# include <algorithm>
+# include "Board.hh"
+
+namespace two48 {
+
+  /// @brief - The possible directions for a move. The naming
+  /// follows the conventions of the `Board` class: a move to
+  /// the right collapses tiles towards positive x and a move
+  /// up collapses them towards `y = 0`, i.e. the top of the
+  /// screen (as `Board::moveVertically(true)`).
+  enum class Direction {
+    Left,
+    Right,
+    Down,
+    Up,
+
+    Count
+  };
+
+  /// @brief - Describe one of the symmetries of a board as the
+  /// composition of a transposition, a reflection along the x axis
+  /// and a reflection along the y axis, applied in this order. As
+  /// the rules of the game are invariant through these operations
+  /// all the images of a board are strategically equivalent. Note
+  /// that only square boards can be transposed.
+  struct Symmetry {
+    // Whether the x and y coordinates are swapped.
+    bool transpose;
+
+    // Whether the x coordinate is mirrored.
+    bool mirrorX;
+
+    // Whether the y coordinate is mirrored.
+    bool mirrorY;
+  };
+
+  /// @brief - Convenience define for the key of a packed board.
+  /// It is an exact representation of the board for boards with
+  /// both dimensions not larger than `4`.
+  using Key = uint64_t;
+
+  /// @brief - A compact value type representing the content of a
+  /// board. Each cell is stored as the exponent of its value in a
+  /// nibble (so `0` is an empty cell, `1` is a `2`, etc.) and each
+  /// row is packed in a single 32 bits integer. This allows boards
+  /// up to `8x8` with tiles up to `32768`: larger tiles saturate.
+  /// Unlike the `Board` this class does not handle any undo stack
+  /// or logging which makes it cheap to copy and suited for the
+  /// exploration of many positions.
+  class PackedBoard {
+    public:
+
+      /// @brief - The maximum dimensions of a packed board.
+      static constexpr unsigned MaxSize = 8u;
+
+      /// @brief - The maximum exponent that can be represented in
+      /// a cell.
+      static constexpr unsigned MaxExponent = 15u;
+
+      /**
+       * @brief - Create a new empty packed board with the specified
+       *          dimensions. Dimensions are clamped to `MaxSize`.
+       * @param width - the width of the board.
+       * @param height - the height of the board.
+       */
+      PackedBoard(unsigned width = 4u,
+                  unsigned height = 4u) noexcept;
+
+      /**
+       * @brief - Create a packed board with the content of the input
+       *          board. Only the first `MaxSize` cells in each axis
+       *          are considered.
+       * @param board - the board to pack.
+       */
+      explicit
+      PackedBoard(const Board& board) noexcept;
+
+      /**
+       * @brief - Create a packed board from its key. Only valid for
+       *          boards where both dimensions are not larger than `4`.
+       * @param key - the key of the board.
+       * @param width - the width of the board.
+       * @param height - the height of the board.
+       * @return - the board corresponding to the key.
+       */
+      static
+      PackedBoard
+      fromKey(Key key, unsigned width, unsigned height) noexcept;
+
+      unsigned
+      w() const noexcept;
+
+      unsigned
+      h() const noexcept;
+
+      /**
+       * @brief - Returns the exponent of the tile at the specified
+       *          position, or `0` if the cell is empty. Coordinates
+       *          are not checked.
+       * @param x - the x coordinate of the cell.
+       * @param y - the y coordinate of the cell.
+       * @return - the exponent of the tile.
+       */
+      unsigned
+      exponent(unsigned x, unsigned y) const noexcept;
+
+      /**
+       * @brief - Returns the packed content of a row: the exponent
+       *          of the cell at `x` is stored in the bits `4x` and
+       *          above. The row is not checked.
+       * @param y - the index of the row.
+       * @return - the packed row.
+       */
+      uint32_t
+      row(unsigned y) const noexcept;
+
+      /**
+       * @brief - Similar to `exponent` but returns the actual value
+       *          of the tile at the specified position.
+       * @param x - the x coordinate of the cell.
+       * @param y - the y coordinate of the cell.
+       * @return - the value of the tile or `0` for an empty cell.
+       */
+      unsigned
+      at(unsigned x, unsigned y) const noexcept;
+
+      /**
+       * @brief - Define the exponent of the tile at the specified
+       *          position. Coordinates are not checked and the value
+       *          is saturated to `MaxExponent`.
+       * @param x - the x coordinate of the cell.
+       * @param y - the y coordinate of the cell.
+       * @param exponent - the exponent of the tile (`0` for empty).
+       */
+      void
+      set(unsigned x, unsigned y, unsigned exponent) noexcept;
+
+      /**
+       * @brief - Returns the number of empty cells in the board.
+       * @return - the count of empty cells.
+       */
+      unsigned
+      empty() const noexcept;
+
+      /**
+       * @brief - Returns the largest exponent of the board.
+       * @return - the exponent of the largest tile.
+       */
+      unsigned
+      maxExponent() const noexcept;
+
+      /**
+       * @brief - Returns the sum of the values of all the tiles.
+       * @return - the sum of the tiles.
+       */
+      unsigned
+      sum() const noexcept;
+
+      /**
+       * @brief - Perform the move in the specified direction. The
+       *          rules are the same as for the `Board` class.
+       * @param d - the direction of the move.
+       * @param score - output argument receiving the points brought
+       *                by the move.
+       * @return - `true` if at least one tile moved.
+       */
+      bool
+      move(const Direction& d, unsigned& score) noexcept;
+
+      /**
+       * @brief - Whether the move in the specified direction would
+       *          change the board.
+       * @param d - the direction to check.
+       * @return - `true` if the move is valid.
+       */
+      bool
+      canMove(const Direction& d) const noexcept;
+
+      /**
+       * @brief - Whether at least one move is valid.
+       * @return - `true` if the game can continue.
+       */
+      bool
+      canMove() const noexcept;
+
+      /**
+       * @brief - Returns a key identifying this board. It is exact
+       *          for boards with dimensions not larger than `4` in
+       *          both axis and a hash otherwise.
+       * @return - the key of the board.
+       */
+      Key
+      key() const noexcept;
+
+      /**
+       * @brief - Swap the x and y axis of the board: the dimensions
+       *          of the board are swapped as well.
+       */
+      void
+      transpose() noexcept;
+
+      /**
+       * @brief - Reflect the board along the x axis: the cell at `x`
+       *          is moved to `w - 1 - x`.
+       */
+      void
+      mirrorX() noexcept;
+
+      /**
+       * @brief - Reflect the board along the y axis: the cell at `y`
+       *          is moved to `h - 1 - y`.
+       */
+      void
+      mirrorY() noexcept;
+
+      /**
+       * @brief - Returns the image of this board through the input
+       *          symmetry.
+       * @param s - the symmetry to apply.
+       * @return - the transformed board.
+       */
+      PackedBoard
+      transformed(const Symmetry& s) const noexcept;
+
+      /**
+       * @brief - Returns the canonical representative of the boards
+       *          equivalent to this one: it is the smallest image of
+       *          the board through the 8 symmetries of a square (or
+       *          the 4 reflections of a rectangle).
+       * @param s - output argument receiving the symmetry mapping
+       *            this board to the canonical one if not `null`.
+       * @return - the canonical board.
+       */
+      PackedBoard
+      canonical(Symmetry* s = nullptr) const noexcept;
+
+      /**
+       * @brief - Returns the key of the canonical representative of
+       *          this board: all equivalent boards share this key.
+       * @return - the canonical key of the board.
+       */
+      Key
+      canonicalKey() const noexcept;
+
+      bool
+      operator==(const PackedBoard& rhs) const noexcept;
+
+      bool
+      operator!=(const PackedBoard& rhs) const noexcept;
+
+    private:
+
+      /**
+       * @brief - Collapse the row at the specified index towards
+       *          the low or high x coordinates.
+       * @param y - the index of the row.
+       * @param positive - `true` to collapse towards high x.
+       * @param score - accumulates the points of the merges.
+       */
+      void
+      collapseRow(unsigned y, bool positive, unsigned& score) noexcept;
+
+      /**
+       * @brief - Collapse the column at the specified index towards
+       *          the low or high y coordinates.
+       * @param x - the index of the column.
+       * @param positive - `true` to collapse towards high y.
+       * @param score - accumulates the points of the merges.
+       */
+      void
+      collapseColumn(unsigned x, bool positive, unsigned& score) noexcept;
+
+    private:
+
+      /**
+       * @brief - The dimensions of the board.
+       */
+      uint8_t m_width;
+      uint8_t m_height;
+
+      /**
+       * @brief - The content of the board: each row holds up to
+       *          `8` nibbles, the cell at `x` being stored in the
+       *          bits `[4x; 4x + 4[`.
+       */
+      std::array<uint32_t, MaxSize> m_rows;
+  };
+
+  /**
+   * @brief - Returns the exponent of the input value: the value is
+   *          assumed to be a power of two (or `0`).
+   * @param value - the value to convert.
+   * @return - the exponent of the value.
+   */
+  unsigned
+  exponentOf(unsigned value) noexcept;
+
+  /**
+   * @brief - Returns the image of the input direction through the
+   *          symmetry: playing `d` on a board is equivalent to play
+   *          the returned direction on the transformed board.
+   * @param d - the direction to transform.
+   * @param s - the symmetry to apply.
+   * @return - the transformed direction.
+   */
+  Direction
+  transform(const Direction& d, const Symmetry& s) noexcept;
+
+  /**
+   * @brief - Reverse operation of `transform`: returns the direction
+   *          on the original board corresponding to the input one on
+   *          the transformed board.
+   * @param d - the direction on the transformed board.
+   * @param s - the symmetry that was applied.
+   * @return - the direction on the original board.
+   */
+  Direction
+  restore(const Direction& d, const Symmetry& s) noexcept;
+
+  /**
+   * @brief - Returns a human readable name for the direction.
+   * @param d - the direction.
+   * @return - the name of the direction.
+   */
+  std::string
+  toString(const Direction& d) noexcept;
+
+}
+
+# include "PackedBoard.hxx"
+
+#endif    /* PACKED_BOARD_HH */
@@ -0,0 +1,175 @@
+#ifndef    PACKED_BOARD_HXX
+# define   PACKED_BOARD_HXX
+
+# include "PackedBoard.hh"
+
+namespace two48 {
+
+  inline
+  unsigned
+  PackedBoard::w() const noexcept {
+    return m_width;
+  }
+
+  inline
+  unsigned
+  PackedBoard::h() const noexcept {
+    return m_height;
+  }
+
+  inline
+  unsigned
+  PackedBoard::exponent(unsigned x, unsigned y) const noexcept {
+    return (m_rows[y] >> (4u * x)) & 0xFu;
+  }
+
+  inline
+  uint32_t
+  PackedBoard::row(unsigned y) const noexcept {
+    return m_rows[y];
+  }
+
+  inline
+  unsigned
+  PackedBoard::at(unsigned x, unsigned y) const noexcept {
+    unsigned e = exponent(x, y);
+    return (e == 0u ? 0u : 1u << e);
+  }
+
+  inline
+  void
+  PackedBoard::set(unsigned x, unsigned y, unsigned exponent) noexcept {
+    uint32_t e = std::min(exponent, MaxExponent);
+    m_rows[y] = (m_rows[y] & ~(0xFu << (4u * x))) | (e << (4u * x));
+  }
+
+  inline
+  bool
+  PackedBoard::canMove() const noexcept {
+    return
+      canMove(Direction::Left) ||
+      canMove(Direction::Right) ||
+      canMove(Direction::Down) ||
+      canMove(Direction::Up)
+    ;
+  }
+
+  inline
+  Key
+  PackedBoard::key() const noexcept {
+    // Small boards fit in a single integer with four
+    // nibbles per row.
+    if (m_width <= 4u && m_height <= 4u) {
+      Key k = 0u;
+      for (unsigned y = 0u ; y < m_height ; ++y) {
+        k |= static_cast<Key>(m_rows[y] & 0xFFFFu) << (16u * y);
+      }
+
+      return k;
+    }
+
+    // Otherwise combine the rows and the dimensions.
+    Key k = (static_cast<Key>(m_width) << 8u) | m_height;
+    for (unsigned y = 0u ; y < m_height ; ++y) {
+      k ^= m_rows[y] + 0x9E3779B97F4A7C15ull + (k << 6u) + (k >> 2u);
+    }
+
+    return k;
+  }
+
+  inline
+  void
+  PackedBoard::transpose() noexcept {
+    // Transpose the whole `8x8` matrix of nibbles by swapping
+    // recursively the off-diagonal blocks of `4x4`, `2x2` and
+    // `1x1` cells. Cells outside of the board are empty so the
+    // board stays in the top left corner.
+    // See Hacker's Delight, section 7-3.
+    constexpr uint32_t masks[3] = {0x0000FFFFu, 0x00FF00FFu, 0x0F0F0F0Fu};
+
+    unsigned level = 0u;
+    for (unsigned j = 4u ; j > 0u ; j >>= 1u, ++level) {
+      for (unsigned k = 0u ; k < MaxSize ; k = (k + j + 1u) & ~j) {
+        uint32_t t = ((m_rows[k] >> (4u * j)) ^ m_rows[k + j]) & masks[level];
+        m_rows[k] ^= (t << (4u * j));
+        m_rows[k + j] ^= t;
+      }
+    }
+
+    std::swap(m_width, m_height);
+  }
+
+  inline
+  void
+  PackedBoard::mirrorX() noexcept {
+    // Reverse the order of the nibbles in each row and then
+    // move the cells of the board back to the lowest bits.
+    unsigned shift = 4u * (MaxSize - m_width);
+
+    for (unsigned y = 0u ; y < m_height ; ++y) {
+      uint32_t r = m_rows[y];
+      r = ((r >> 4u) & 0x0F0F0F0Fu) | ((r & 0x0F0F0F0Fu) << 4u);
+      r = ((r >> 8u) & 0x00FF00FFu) | ((r & 0x00FF00FFu) << 8u);
+      r = (r >> 16u) | (r << 16u);
+
+      m_rows[y] = r >> shift;
+    }
+  }
+
+  inline
+  void
+  PackedBoard::mirrorY() noexcept {
+    std::reverse(m_rows.begin(), m_rows.begin() + m_height);
+  }
+
+  inline
+  PackedBoard
+  PackedBoard::transformed(const Symmetry& s) const noexcept {
+    PackedBoard b = *this;
+
+    if (s.transpose) {
+      b.transpose();
+    }
+    if (s.mirrorX) {
+      b.mirrorX();
+    }
+    if (s.mirrorY) {
+      b.mirrorY();
+    }
+
+    return b;
+  }
+
+  inline
+  Key
+  PackedBoard::canonicalKey() const noexcept {
+    return canonical().key();
+  }
+
+  inline
+  bool
+  PackedBoard::operator==(const PackedBoard& rhs) const noexcept {
+    return m_width == rhs.m_width && m_height == rhs.m_height && m_rows == rhs.m_rows;
+  }
+
+  inline
+  bool
+  PackedBoard::operator!=(const PackedBoard& rhs) const noexcept {
+    return !operator==(rhs);
+  }
+
+  inline
+  unsigned
+  exponentOf(unsigned value) noexcept {
+    unsigned e = 0u;
+    while (value > 1u) {
+      value >>= 1u;
+      ++e;
+    }
+
+    return e;
+  }
+
+}
+
+#endif    /* PACKED_BOARD_HXX */
@@ -1,6 +1,7 @@
 
 # include "SavedGames.hh"
 # include <filesystem>
+# include "Tracer.hh"
 
 namespace {
 
@@ -121,6 +122,8 @@ namespace pge {
 
   void
   SavedGames::refresh() {
+    profiling::Span span("scan saved games", "io");
+
     // Refresh the list of games that can be loaded by
     // re-reading the content of the save directory.
     // Note that we do not update the displayed values
@@ -0,0 +1,341 @@
+
+# include "Search.hh"
+# include <cmath>
+# include <array>
+# include <core_utils/TimeUtils.hh>
+
+/// @brief - The probability to spawn a `2` rather than a `4`
+/// after a move: this should match the rules of the game.
+# define SPAWN_TWO_PROBABILITY 0.9f
+
+/// @brief - Below this probability a branch of the search is
+/// not explored anymore and evaluated with the heuristic.
+# define PROBABILITY_CUTOFF 0.0001f
+
+/// @brief - The number of nodes processed between two checks
+/// of the time spent in a slice of the search.
+# define NODES_PER_TIME_CHECK 64u
+
+/// @brief - The weights of the terms of the heuristic.
+# define LOST_PENALTY        200000.0f
+# define EMPTY_WEIGHT        270.0f
+# define MERGES_WEIGHT       700.0f
+# define MONOTONICITY_POWER  4.0f
+# define MONOTONICITY_WEIGHT 47.0f
+# define SUM_POWER           3.5f
+# define SUM_WEIGHT          11.0f
+
+namespace {
+
+  /// @brief - Convenience define for a table of the powers of
+  /// the exponents of the tiles.
+  using Powers = std::array<float, two48::PackedBoard::MaxExponent + 1u>;
+
+  /**
+   * @brief - Precompute the powers of each exponent.
+   * @param power - the power to raise the exponents to.
+   * @return - the table of powers.
+   */
+  Powers
+  generatePowers(float power) noexcept {
+    Powers out;
+    for (unsigned e = 0u ; e < out.size() ; ++e) {
+      out[e] = std::pow(static_cast<float>(e), power);
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - Evaluate a single line of the board.
+   * @param row - the packed row to evaluate.
+   * @param count - the number of cells in the row.
+   * @return - the value of the line.
+   */
+  float
+  evaluateLine(uint32_t row, unsigned count) noexcept {
+    static const Powers sums = generatePowers(SUM_POWER);
+    static const Powers monotonicity = generatePowers(MONOTONICITY_POWER);
+
+    float sum = 0.0f, left = 0.0f, right = 0.0f;
+    unsigned empty = 0u, merges = 0u;
+
+    unsigned prev = 0u, counter = 0u;
+
+    for (unsigned c = 0u ; c < count ; ++c) {
+      unsigned e = (row >> (4u * c)) & 0xFu;
+      sum += sums[e];
+
+      if (e == 0u) {
+        ++empty;
+        continue;
+      }
+
+      // Count the tiles that can be merged with their
+      // neighbor, ignoring the empty cells.
+      if (prev == e) {
+        ++counter;
+      }
+      else if (counter > 0u) {
+        merges += 1u + counter;
+        counter = 0u;
+      }
+      prev = e;
+    }
+    if (counter > 0u) {
+      merges += 1u + counter;
+    }
+
+    // Penalize lines which are not monotonic.
+    for (unsigned c = 1u ; c < count ; ++c) {
+      float a = monotonicity[(row >> (4u * (c - 1u))) & 0xFu];
+      float b = monotonicity[(row >> (4u * c)) & 0xFu];
+
+      if (a > b) {
+        left += a - b;
+      }
+      else {
+        right += b - a;
+      }
+    }
+
+    // The lost penalty is counted for each line so that any
+    // board is better than a lost one.
+    return
+      LOST_PENALTY +
+      EMPTY_WEIGHT * empty +
+      MERGES_WEIGHT * merges -
+      MONOTONICITY_WEIGHT * std::min(left, right) -
+      SUM_WEIGHT * sum
+    ;
+  }
+
+}
+
+namespace two48 {
+
+  Search::Search(unsigned depth) noexcept:
+    m_depth(std::max(depth, 1u)),
+
+    m_root(),
+    m_iteration(0u),
+    m_reached(0u),
+
+    m_move(Direction::Count),
+    m_value(0.0f),
+    m_candidate(Direction::Count),
+    m_candidateValue(0.0f),
+
+    m_stack(),
+    m_cache()
+  {}
+
+  Direction
+  Search::best(const PackedBoard& board, float* value) {
+    start(board, false);
+    resume();
+
+    return move(value);
+  }
+
+  void
+  Search::start(const PackedBoard& board, bool deepening) {
+    m_root = board;
+    m_reached = 0u;
+    m_move = Direction::Count;
+    m_value = 0.0f;
+
+    m_stack.clear();
+    m_cache.clear();
+
+    pushRoot(deepening ? 1u : m_depth);
+  }
+
+  bool
+  Search::resume(float budget) {
+    utils::TimeStamp start = utils::now();
+
+    while (!m_stack.empty()) {
+      for (unsigned id = 0u ; id < NODES_PER_TIME_CHECK && !m_stack.empty() ; ++id) {
+        advance();
+      }
+
+      if (budget > 0.0f && utils::diffInMs(start, utils::now()) * 1000.0f >= budget) {
+        break;
+      }
+    }
+
+    return m_stack.empty();
+  }
+
+  bool
+  Search::explore(unsigned nodes) {
+    for (unsigned id = 0u ; id < nodes && !m_stack.empty() ; ++id) {
+      advance();
+    }
+
+    return m_stack.empty();
+  }
+
+  float
+  Search::heuristic(const PackedBoard& board) noexcept {
+    float v = 0.0f;
+
+    // Columns are evaluated as the rows of the transposed
+    // board.
+    PackedBoard t = board;
+    t.transpose();
+
+    for (unsigned y = 0u ; y < board.h() ; ++y) {
+      v += evaluateLine(board.row(y), board.w());
+    }
+    for (unsigned y = 0u ; y < t.h() ; ++y) {
+      v += evaluateLine(t.row(y), t.w());
+    }
+
+    return v;
+  }
+
+  void
+  Search::pushRoot(unsigned depth) {
+    m_iteration = depth;
+    m_candidate = Direction::Count;
+    m_candidateValue = 0.0f;
+
+    // The root is a player node: its children are chance
+    // nodes which consume one level of depth.
+    m_stack.push_back(Node{Kind::Max, m_root, depth - 1u, 1.0f, 0u, 0u, 0.0f, 0.0f});
+  }
+
+  void
+  Search::advance() {
+    Node& n = m_stack.back();
+
+    if (n.kind == Kind::Max) {
+      while (n.next < static_cast<unsigned>(Direction::Count)) {
+        Direction d = static_cast<Direction>(n.next);
+        ++n.next;
+
+        PackedBoard moved = n.board;
+        unsigned points = 0u;
+        if (!moved.move(d, points)) {
+          continue;
+        }
+
+        // Only explore the chance node if its value can't be
+        // determined right away.
+        float v = 0.0f;
+        if (evaluate(moved, n.depth, n.probability, v)) {
+          propagate(v);
+          return;
+        }
+
+        unsigned empty = moved.empty();
+        m_stack.push_back(Node{Kind::Chance, moved, n.depth, n.probability, 0u, empty, 0.0f, 0.0f});
+        return;
+      }
+
+      // All moves were explored: a board with no moves is
+      // a lost game and is worth nothing.
+      float v = n.value;
+      m_stack.pop_back();
+      propagate(v);
+
+      return;
+    }
+
+    // Each empty cell can receive a `2` or a `4`.
+    unsigned cells = n.board.w() * n.board.h();
+
+    while (n.next < 2u * cells) {
+      unsigned cell = n.next / 2u;
+      bool four = (n.next % 2u == 1u);
+      ++n.next;
+
+      unsigned x = cell % n.board.w(), y = cell / n.board.w();
+      if (n.board.exponent(x, y) != 0u) {
+        continue;
+      }
+
+      n.weight = (four ? 1.0f - SPAWN_TWO_PROBABILITY : SPAWN_TWO_PROBABILITY);
+
+      PackedBoard s = n.board;
+      s.set(x, y, four ? 2u : 1u);
+
+      // Note that pushing invalidates the reference to the
+      // current node.
+      Node child{Kind::Max, s, n.depth - 1u, n.probability * n.weight / n.empty, 0u, 0u, 0.0f, 0.0f};
+      m_stack.push_back(child);
+
+      return;
+    }
+
+    float v = n.value / n.empty;
+    m_cache[n.board.canonicalKey()] = Transposition{n.depth, v};
+
+    m_stack.pop_back();
+    propagate(v);
+  }
+
+  bool
+  Search::evaluate(const PackedBoard& board, unsigned depth, float probability, float& value) const {
+    if (depth == 0u || probability < PROBABILITY_CUTOFF) {
+      value = heuristic(board);
+      return true;
+    }
+
+    // Symmetric positions share the same value.
+    std::unordered_map<Key, Transposition>::const_iterator it = m_cache.find(board.canonicalKey());
+    if (it != m_cache.cend() && it->second.depth >= depth) {
+      value = it->second.value;
+      return true;
+    }
+
+    // A valid move always leaves at least an empty cell
+    // but we make sure to not divide by zero.
+    if (board.empty() == 0u) {
+      value = heuristic(board);
+      return true;
+    }
+
+    return false;
+  }
+
+  void
+  Search::propagate(float value) {
+    // The root was completed: publish its best move and go
+    // on with the next iteration if needed.
+    if (m_stack.empty()) {
+      m_move = m_candidate;
+      m_value = m_candidateValue;
+      m_reached = m_iteration;
+
+      if (m_iteration < m_depth && m_candidate != Direction::Count) {
+        pushRoot(m_iteration + 1u);
+      }
+
+      return;
+    }
+
+    Node& parent = m_stack.back();
+
+    if (parent.kind == Kind::Chance) {
+      parent.value += parent.weight * value;
+      return;
+    }
+
+    parent.value = std::max(parent.value, value);
+
+    // Track the best move of the root: the direction that
+    // led to this value was the last one explored.
+    if (m_stack.size() > 1u) {
+      return;
+    }
+
+    if (m_candidate == Direction::Count || value > m_candidateValue) {
+      m_candidate = static_cast<Direction>(parent.next - 1u);
+      m_candidateValue = value;
+    }
+  }
+
+}
@@ -0,0 +1,264 @@
+#ifndef    SEARCH_HH
+# define   SEARCH_HH
+
+# include <vector>
+# include <memory>
+# include <unordered_map>
+# include "PackedBoard.hh"
+
+namespace two48 {
+
+  /// @brief - Expectimax search for the best move of a board. The
+  /// player nodes maximize over the possible moves while the chance
+  /// nodes average over the possible spawns of a tile. Leaves are
+  /// evaluated with a heuristic favoring empty cells, monotonic
+  /// rows and columns and possible merges.
+  /// Unlike the `Solver` this works for boards of any size but the
+  /// result is only an approximation of the optimal play.
+  /// The search is implemented with an explicit stack of nodes so
+  /// that it can be interrupted and resumed at any point: this is
+  /// used to spread a search over several frames. It proceeds by
+  /// iterative deepening so that a move is available as soon as a
+  /// first shallow search is complete.
+  class Search {
+    public:
+
+      /**
+       * @brief - Create a new search with the specified depth.
+       * @param depth - the number of moves of the player explored
+       *                from the root board.
+       */
+      explicit
+      Search(unsigned depth = 3u) noexcept;
+
+      /**
+       * @brief - The depth of the search.
+       * @return - the number of moves explored.
+       */
+      unsigned
+      depth() const noexcept;
+
+      /**
+       * @brief - Compute the best move for the input board. This
+       *          performs the whole search at once.
+       * @param board - the board to analyze.
+       * @param value - output argument receiving the expected value
+       *                of the best move if not `null`.
+       * @return - the best move or `Count` if no move is possible.
+       */
+      Direction
+      best(const PackedBoard& board, float* value = nullptr);
+
+      /**
+       * @brief - Start a new search for the input board. Any search
+       *          in progress is discarded. No work is performed until
+       *          the `resume` method is called.
+       * @param board - the board to analyze.
+       * @param deepening - `true` to search with increasing depths
+       *                    up to the depth of the search, `false`
+       *                    to directly search at full depth.
+       */
+      void
+      start(const PackedBoard& board, bool deepening = true);
+
+      /**
+       * @brief - Continue the current search for at most the input
+       *          duration. Note that the time is checked every few
+       *          nodes so the budget can be slightly exceeded.
+       * @param budget - the maximum duration of this slice of the
+       *                 search in microseconds. A value of `0` runs
+       *                 the search until completion.
+       * @return - `true` if the search is complete.
+       */
+      bool
+      resume(float budget = 0.0f);
+
+      /**
+       * @brief - Continue the current search for at most the input
+       *          number of nodes. Unlike `resume` the progress of
+       *          the search only depends on the board, e.g. to get
+       *          the same moves when a game is replayed.
+       * @param nodes - the maximum number of nodes explored in this
+       *                slice of the search.
+       * @return - `true` if the search is complete.
+       */
+      bool
+      explore(unsigned nodes);
+
+      /**
+       * @brief - Whether the search started for the current board
+       *          reached its full depth.
+       * @return - `true` if the search is complete.
+       */
+      bool
+      done() const noexcept;
+
+      /**
+       * @brief - The best move found by the deepest iteration that
+       *          was completed so far.
+       * @param value - output argument receiving the expected value
+       *                of the move if not `null`.
+       * @return - the best move or `Count` if none is known yet.
+       */
+      Direction
+      move(float* value = nullptr) const noexcept;
+
+      /**
+       * @brief - The depth of the deepest iteration completed for
+       *          the current board.
+       * @return - the depth reached by the search.
+       */
+      unsigned
+      reached() const noexcept;
+
+      /**
+       * @brief - Evaluate statically the input board: the larger
+       *          the better for the player.
+       * @param board - the board to evaluate.
+       * @return - the heuristic value of the board.
+       */
+      static
+      float
+      heuristic(const PackedBoard& board) noexcept;
+
+    private:
+
+      /// @brief - The type of a node of the search.
+      enum class Kind {
+        // The player chooses a move.
+        Max,
+
+        // A tile is spawned in an empty cell.
+        Chance
+      };
+
+      /// @brief - A node of the search being explored.
+      struct Node {
+        // The type of node.
+        Kind kind;
+
+        // The board at this node.
+        PackedBoard board;
+
+        // The remaining moves to explore.
+        unsigned depth;
+
+        // The probability to reach this node.
+        float probability;
+
+        // The next child to explore: a direction for a player
+        // node and a cell and a tile for a chance node.
+        unsigned next;
+
+        // The number of empty cells for chance nodes.
+        unsigned empty;
+
+        // The best value of the children for player nodes or
+        // the weighted sum of their values for chance nodes.
+        float value;
+
+        // The weight of the child being explored for chance
+        // nodes.
+        float weight;
+      };
+
+      /// @brief - An entry of the transposition table: the value is
+      /// valid for searches with at most the registered depth.
+      struct Transposition {
+        unsigned depth;
+        float value;
+      };
+
+      /**
+       * @brief - Push the root node of a new iteration of the search.
+       * @param depth - the depth of the iteration.
+       */
+      void
+      pushRoot(unsigned depth);
+
+      /**
+       * @brief - Process the next child of the node at the top of
+       *          the stack or complete the node if all its children
+       *          were explored.
+       */
+      void
+      advance();
+
+      /**
+       * @brief - Try to evaluate the chance node reached after the
+       *          input board without exploring it: this is possible
+       *          for leaves and nodes already in the cache.
+       * @param board - the board of the chance node.
+       * @param depth - the remaining moves to explore.
+       * @param probability - the probability to reach this board.
+       * @param value - output argument receiving the value.
+       * @return - `true` if the value could be computed.
+       */
+      bool
+      evaluate(const PackedBoard& board, unsigned depth, float probability, float& value) const;
+
+      /**
+       * @brief - Propagate the value of a completed node to its
+       *          parent, or complete the iteration if the node is
+       *          the root of the search.
+       * @param value - the value of the node.
+       */
+      void
+      propagate(float value);
+
+    private:
+
+      /**
+       * @brief - The depth of the search.
+       */
+      unsigned m_depth;
+
+      /**
+       * @brief - The board at the root of the search.
+       */
+      PackedBoard m_root;
+
+      /**
+       * @brief - The depth of the iteration in progress.
+       */
+      unsigned m_iteration;
+
+      /**
+       * @brief - The depth of the deepest iteration completed for
+       *          the current board.
+       */
+      unsigned m_reached;
+
+      /**
+       * @brief - The best move and its value as computed by the
+       *          deepest completed iteration.
+       */
+      Direction m_move;
+      float m_value;
+
+      /**
+       * @brief - The best move and its value for the iteration in
+       *          progress.
+       */
+      Direction m_candidate;
+      float m_candidateValue;
+
+      /**
+       * @brief - The nodes being explored: the root is at the
+       *          bottom of the stack.
+       */
+      std::vector<Node> m_stack;
+
+      /**
+       * @brief - The values of the chance nodes already visited in
+       *          the current search, keyed by their canonical key.
+       */
+      std::unordered_map<Key, Transposition> m_cache;
+  };
+
+  using SearchShPtr = std::shared_ptr<Search>;
+}
+
+# include "Search.hxx"
+
+#endif    /* SEARCH_HH */
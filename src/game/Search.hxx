@@ -0,0 +1,38 @@
+#ifndef    SEARCH_HXX
+# define   SEARCH_HXX
+
+# include "Search.hh"
+
+namespace two48 {
+
+  inline
+  unsigned
+  Search::depth() const noexcept {
+    return m_depth;
+  }
+
+  inline
+  bool
+  Search::done() const noexcept {
+    return m_stack.empty();
+  }
+
+  inline
+  Direction
+  Search::move(float* value) const noexcept {
+    if (value != nullptr) {
+      *value = m_value;
+    }
+
+    return m_move;
+  }
+
+  inline
+  unsigned
+  Search::reached() const noexcept {
+    return m_reached;
+  }
+
+}
+
+#endif    /* SEARCH_HXX */
@@ -0,0 +1,102 @@
+
+# include "SolvedTable.hh"
+# include <cstring>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "Tracer.hh"
+
+namespace two48 {
+
+  SolvedTable::SolvedTable() noexcept:
+    utils::CoreObject("table"),
+
+    m_data(nullptr),
+    m_size(0u),
+
+    m_header(nullptr),
+    m_entries(nullptr)
+  {
+    setService("2048");
+  }
+
+  SolvedTable::~SolvedTable() {
+    release();
+  }
+
+  bool
+  SolvedTable::load(const std::string& file) {
+    profiling::Span span("load solved table", "io");
+
+    release();
+
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+      debug("No solved table available in \"" + file + "\"");
+      return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(solver::Header)) {
+      warn("Failed to load solved table \"" + file + "\"", "File is too small");
+      ::close(fd);
+      return false;
+    }
+
+    // The mapping stays valid after closing the file.
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+      warn("Failed to load solved table \"" + file + "\"", "Failed to map file");
+      return false;
+    }
+
+    const solver::Header* header = reinterpret_cast<const solver::Header*>(data);
+
+    bool valid =
+      std::memcmp(header->magic, solver::Magic, sizeof(solver::Magic)) == 0 &&
+      header->version == solver::Version &&
+      header->capacity > 0u &&
+      (header->capacity & (header->capacity - 1u)) == 0u &&
+      header->count < header->capacity &&
+      size == sizeof(solver::Header) + header->capacity * sizeof(solver::Entry)
+    ;
+
+    if (!valid) {
+      warn("Failed to load solved table \"" + file + "\"", "Invalid header");
+      ::munmap(data, size);
+      return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_header = header;
+    m_entries = reinterpret_cast<const solver::Entry*>(
+      reinterpret_cast<const char*>(data) + sizeof(solver::Header)
+    );
+
+    info(
+      "Loaded solved table for " + std::to_string(m_header->width) + "x" +
+      std::to_string(m_header->height) + " with " + std::to_string(m_header->count) +
+      " state(s) from \"" + file + "\""
+    );
+
+    return true;
+  }
+
+  void
+  SolvedTable::release() noexcept {
+    if (m_data != nullptr) {
+      ::munmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0u;
+    m_header = nullptr;
+    m_entries = nullptr;
+  }
+
+}
@@ -0,0 +1,193 @@
+#ifndef    SOLVED_TABLE_HH
+# define   SOLVED_TABLE_HH
+
+# include <memory>
+# include <cstdint>
+# include <core_utils/CoreObject.hh>
+# include "PackedBoard.hh"
+
+namespace two48 {
+  namespace solver {
+
+    /// @brief - The magic string identifying a solved table file.
+    constexpr char Magic[8] = {'2', '0', '4', '8', 'S', 'O', 'L', 'V'};
+
+    /// @brief - The version of the format of the solved tables.
+    constexpr uint32_t Version = 3u;
+
+    /// @brief - The header of a solved table file. It is followed
+    /// by `capacity` entries forming an open addressing hash table
+    /// indexed by the canonical key of the boards (see the method
+    /// `PackedBoard::canonical`): empty slots have a key of `0`
+    /// (which never corresponds to a reachable board). As all the
+    /// symmetric images of a board share a single entry the moves
+    /// are expressed relatively to the canonical board.
+    struct Header {
+      // The magic string of the file.
+      char magic[8];
+
+      // The version of the format.
+      uint32_t version;
+
+      // The dimensions of the board for this table.
+      uint32_t width;
+      uint32_t height;
+
+      // The value of the tile considered as a win.
+      uint32_t target;
+
+      // The number of slots in the table: always a power of two.
+      uint64_t capacity;
+
+      // The number of states registered in the table.
+      uint64_t count;
+    };
+
+    /// @brief - The information stored for each state of the board.
+    struct Entry {
+      // The key of the board.
+      Key key;
+
+      // The expected score that can still be obtained from this
+      // position with an optimal play.
+      float score;
+
+      // The maximum probability to reach the target tile from
+      // this position.
+      float win;
+
+      // The move maximizing the expected score, as a value of the
+      // `Direction` enumeration (`Count` if the game is over).
+      uint8_t move;
+
+      // The move maximizing the probability to win.
+      uint8_t winMove;
+
+      // Padding to keep entries aligned on 8 bytes.
+      uint8_t padding[6];
+    };
+
+    static_assert(sizeof(Header) == 40u, "Unexpected size for solved table header");
+    static_assert(sizeof(Entry) == 24u, "Unexpected size for solved table entry");
+
+    /**
+     * @brief - Returns the slot of the hash table where the search
+     *          for the input key should begin.
+     * @param key - the key of the board.
+     * @param capacity - the capacity of the table: must be a power
+     *                   of two.
+     * @return - the index of the first slot to probe.
+     */
+    uint64_t
+    slot(Key key, uint64_t capacity) noexcept;
+
+  }
+
+  class SolvedTable: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new empty table: no query will succeed
+       *          until a table is loaded.
+       */
+      SolvedTable() noexcept;
+
+      /**
+       * @brief - Release the mapping of the table if any.
+       */
+      ~SolvedTable();
+
+      SolvedTable(const SolvedTable&) = delete;
+
+      SolvedTable&
+      operator=(const SolvedTable&) = delete;
+
+      /**
+       * @brief - Map the input file in memory and use it as the
+       *          source of the queries. Any previously loaded
+       *          table is released.
+       *          As tables are optional resources, a missing or
+       *          invalid file is not an error: the table is left
+       *          empty and `false` is returned.
+       * @param file - the path to the solved table.
+       * @return - `true` if the table could be loaded.
+       */
+      bool
+      load(const std::string& file);
+
+      /**
+       * @brief - Release the table currently mapped if any.
+       */
+      void
+      release() noexcept;
+
+      /**
+       * @brief - Whether this table can answer queries for boards
+       *          with the specified dimensions.
+       * @param width - the width of the board.
+       * @param height - the height of the board.
+       * @return - `true` if the table is loaded for this size.
+       */
+      bool
+      matches(unsigned width, unsigned height) const noexcept;
+
+      /**
+       * @brief - The value of the tile considered as a win in the
+       *          loaded table, or `0` if no table is loaded.
+       * @return - the target tile.
+       */
+      unsigned
+      target() const noexcept;
+
+      /**
+       * @brief - Fetch the entry describing the input board. This
+       *          is a constant time operation. The moves of the
+       *          entry are converted back from the canonical board
+       *          to the input one.
+       * @param board - the board to search for.
+       * @param entry - output argument receiving the entry.
+       * @return - `true` if the board is known.
+       */
+      bool
+      find(const PackedBoard& board, solver::Entry& entry) const noexcept;
+
+    private:
+
+      /**
+       * @brief - Convert a move stored in the table for a canonical
+       *          board to the board it was obtained from.
+       * @param move - the move in the table.
+       * @param s - the symmetry mapping the board to the canonical
+       *            one.
+       * @return - the move for the original board.
+       */
+      static
+      uint8_t
+      restoreMove(uint8_t move, const Symmetry& s) noexcept;
+
+    private:
+
+      /**
+       * @brief - The memory mapped content of the file.
+       */
+      void* m_data;
+
+      /**
+       * @brief - The size in bytes of the mapping.
+       */
+      std::size_t m_size;
+
+      /**
+       * @brief - Convenience pointers to the header and entries of
+       *          the mapped table.
+       */
+      const solver::Header* m_header;
+      const solver::Entry* m_entries;
+  };
+
+  using SolvedTableShPtr = std::shared_ptr<SolvedTable>;
+}
+
+# include "SolvedTable.hxx"
+
+#endif    /* SOLVED_TABLE_HH */
@@ -0,0 +1,78 @@
+#ifndef    SOLVED_TABLE_HXX
+# define   SOLVED_TABLE_HXX
+
+# include "SolvedTable.hh"
+
+namespace two48 {
+  namespace solver {
+
+    inline
+    uint64_t
+    slot(Key key, uint64_t capacity) noexcept {
+      // Finalizer of the `splitmix64` generator: it
+      // spreads the nibbles of the key over all bits.
+      key ^= key >> 30u;
+      key *= 0xBF58476D1CE4E5B9ull;
+      key ^= key >> 27u;
+      key *= 0x94D049BB133111EBull;
+      key ^= key >> 31u;
+
+      return key & (capacity - 1u);
+    }
+
+  }
+
+  inline
+  uint8_t
+  SolvedTable::restoreMove(uint8_t move, const Symmetry& s) noexcept {
+    if (move >= static_cast<uint8_t>(Direction::Count)) {
+      return move;
+    }
+
+    return static_cast<uint8_t>(restore(static_cast<Direction>(move), s));
+  }
+
+  inline
+  bool
+  SolvedTable::matches(unsigned width, unsigned height) const noexcept {
+    return m_header != nullptr && m_header->width == width && m_header->height == height;
+  }
+
+  inline
+  unsigned
+  SolvedTable::target() const noexcept {
+    return (m_header == nullptr ? 0u : m_header->target);
+  }
+
+  inline
+  bool
+  SolvedTable::find(const PackedBoard& board, solver::Entry& entry) const noexcept {
+    if (!matches(board.w(), board.h())) {
+      return false;
+    }
+
+    Symmetry s;
+    Key k = board.canonical(&s).key();
+    uint64_t mask = m_header->capacity - 1u;
+    uint64_t id = solver::slot(k, m_header->capacity);
+
+    // The table is never full so the probing always
+    // ends on an empty slot for unknown boards.
+    while (m_entries[id].key != 0u) {
+      if (m_entries[id].key == k) {
+        entry = m_entries[id];
+        entry.move = restoreMove(entry.move, s);
+        entry.winMove = restoreMove(entry.winMove, s);
+
+        return true;
+      }
+
+      id = (id + 1u) & mask;
+    }
+
+    return false;
+  }
+
+}
+
+#endif    /* SOLVED_TABLE_HXX */
@@ -0,0 +1,382 @@
+
+# include "Solver.hh"
+# include <thread>
+# include <fstream>
+# include <algorithm>
+# include <core_utils/TimeUtils.hh>
+
+/// @brief - The probability to spawn a `2` rather than a `4`
+/// after a move: this should match the rules of the game.
+# define SPAWN_TWO_PROBABILITY 0.9f
+
+/// @brief - The maximum number of cells of a board that can be
+/// solved exactly.
+# define MAX_SOLVED_CELLS 9u
+
+namespace {
+
+  /**
+   * @brief - Sort the keys and remove duplicates.
+   * @param keys - the keys to process.
+   */
+  void
+  deduplicate(std::vector<two48::Key>& keys) noexcept {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+
+  /**
+   * @brief - Find the index of the key in the sorted input list.
+   * @param keys - the sorted keys.
+   * @param key - the key to search for.
+   * @return - the index of the key or the size of the list if it
+   *           is not found.
+   */
+  std::size_t
+  indexOf(const std::vector<two48::Key>& keys, two48::Key key) noexcept {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) {
+      return keys.size();
+    }
+
+    return static_cast<std::size_t>(it - keys.begin());
+  }
+
+}
+
+namespace two48 {
+
+  Solver::Solver(unsigned width,
+                 unsigned height,
+                 unsigned threads):
+    utils::CoreObject("solver"),
+
+    m_width(width),
+    m_height(height),
+
+    m_threads(threads == 0u ? std::max(std::thread::hardware_concurrency(), 1u) : threads),
+
+    m_target(0u),
+    m_layers()
+  {
+    setService("2048");
+
+    if (m_width < 2u || m_height < 2u || m_width > 4u || m_height > 4u ||
+        m_width * m_height > MAX_SOLVED_CELLS)
+    {
+      error(
+        "Failed to create solver",
+        "Unsupported board of size " + std::to_string(m_width) + "x" + std::to_string(m_height)
+      );
+    }
+  }
+
+  void
+  Solver::solve(unsigned target) {
+    utils::TimeStamp start = utils::now();
+
+    m_layers.clear();
+    enumerate();
+
+    // Use the largest reachable tile if no target is
+    // provided: the last layer contains it.
+    unsigned exp = exponentOf(target);
+    if (target == 0u) {
+      for (const std::pair<const unsigned, Layer>& l : m_layers) {
+        for (Key k : l.second.keys) {
+          exp = std::max(exp, PackedBoard::fromKey(k, m_width, m_height).maxExponent());
+        }
+      }
+    }
+
+    m_target = 1u << exp;
+
+    info(
+      "Found " + std::to_string(states()) + " position(s) in " +
+      std::to_string(m_layers.size()) + " layer(s) for " + std::to_string(m_width) +
+      "x" + std::to_string(m_height) + ", target is " + std::to_string(m_target)
+    );
+
+    evaluate(exp);
+
+    info("Solved board in " + std::to_string(utils::diffInMs(start, utils::now())) + "ms");
+  }
+
+  std::size_t
+  Solver::states() const noexcept {
+    std::size_t count = 0u;
+    for (const std::pair<const unsigned, Layer>& l : m_layers) {
+      count += l.second.keys.size();
+    }
+
+    return count;
+  }
+
+  void
+  Solver::save(const std::string& file) const {
+    // Build the open addressing table: we keep the load
+    // factor under one half to keep probing short.
+    uint64_t capacity = 1u;
+    while (capacity < 2u * states() + 1u) {
+      capacity <<= 1u;
+    }
+
+    std::vector<solver::Entry> table(capacity, solver::Entry{});
+
+    for (const std::pair<const unsigned, Layer>& it : m_layers) {
+      const Layer& l = it.second;
+
+      for (std::size_t id = 0u ; id < l.keys.size() ; ++id) {
+        uint64_t s = solver::slot(l.keys[id], capacity);
+        while (table[s].key != 0u) {
+          s = (s + 1u) & (capacity - 1u);
+        }
+
+        table[s].key = l.keys[id];
+        table[s].score = l.score[id];
+        table[s].win = l.win[id];
+        table[s].move = l.move[id];
+        table[s].winMove = l.winMove[id];
+      }
+    }
+
+    solver::Header header{};
+    std::copy(solver::Magic, solver::Magic + sizeof(solver::Magic), header.magic);
+    header.version = solver::Version;
+    header.width = m_width;
+    header.height = m_height;
+    header.target = m_target;
+    header.capacity = capacity;
+    header.count = states();
+
+    std::ofstream out(file.c_str(), std::ios::binary);
+    if (!out.good()) {
+      error(
+        "Failed to save solved table to \"" + file + "\"",
+        "Failed to open file"
+      );
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(solver::Header));
+    out.write(reinterpret_cast<const char*>(table.data()), capacity * sizeof(solver::Entry));
+
+    info(
+      "Saved " + std::to_string(header.count) + " position(s) in " +
+      std::to_string(capacity) + " slot(s) to \"" + file + "\""
+    );
+  }
+
+  void
+  Solver::enumerate() {
+    // The initial states are made of two tiles with a
+    // value of `2` or `4` anywhere on the board.
+    unsigned cells = m_width * m_height;
+
+    for (unsigned c1 = 0u ; c1 < cells ; ++c1) {
+      for (unsigned c2 = c1 + 1u ; c2 < cells ; ++c2) {
+        for (unsigned e1 = 1u ; e1 <= 2u ; ++e1) {
+          for (unsigned e2 = 1u ; e2 <= 2u ; ++e2) {
+            PackedBoard b(m_width, m_height);
+            b.set(c1 % m_width, c1 / m_width, e1);
+            b.set(c2 % m_width, c2 / m_width, e2);
+
+            m_layers[b.sum()].keys.push_back(b.canonicalKey());
+          }
+        }
+      }
+    }
+
+    // Traverse layers by increasing sum: when a layer is
+    // reached all its predecessors were already visited.
+    // Note that inserting new layers in the map does not
+    // invalidate the iterator.
+    std::vector<std::vector<Key>> twos(m_threads);
+    std::vector<std::vector<Key>> fours(m_threads);
+
+    for (std::map<unsigned, Layer>::iterator it = m_layers.begin() ; it != m_layers.end() ; ++it) {
+      unsigned sum = it->first;
+      std::vector<Key>& keys = it->second.keys;
+
+      deduplicate(keys);
+
+      verbose("Expanding layer " + std::to_string(sum) + " with " + std::to_string(keys.size()) + " position(s)");
+
+      for (unsigned worker = 0u ; worker < m_threads ; ++worker) {
+        twos[worker].clear();
+        fours[worker].clear();
+      }
+
+      parallelFor(
+        keys.size(),
+        [&](std::size_t begin, std::size_t end, unsigned worker) {
+          std::vector<Key>& t = twos[worker];
+          std::vector<Key>& f = fours[worker];
+
+          for (std::size_t id = begin ; id < end ; ++id) {
+            PackedBoard b = PackedBoard::fromKey(keys[id], m_width, m_height);
+
+            for (unsigned d = 0u ; d < static_cast<unsigned>(Direction::Count) ; ++d) {
+              PackedBoard moved = b;
+              unsigned score = 0u;
+              if (!moved.move(static_cast<Direction>(d), score)) {
+                continue;
+              }
+
+              for (unsigned y = 0u ; y < m_height ; ++y) {
+                for (unsigned x = 0u ; x < m_width ; ++x) {
+                  if (moved.exponent(x, y) != 0u) {
+                    continue;
+                  }
+
+                  PackedBoard s = moved;
+                  s.set(x, y, 1u);
+                  t.push_back(s.canonicalKey());
+                  s.set(x, y, 2u);
+                  f.push_back(s.canonicalKey());
+                }
+              }
+            }
+          }
+
+          deduplicate(t);
+          deduplicate(f);
+        }
+      );
+
+      // Merge the successors in their respective layers.
+      // They will be deduplicated when reached. We don't
+      // create layers for positions with no successors
+      // so that the traversal ends.
+      for (unsigned worker = 0u ; worker < m_threads ; ++worker) {
+        if (!twos[worker].empty()) {
+          std::vector<Key>& l2 = m_layers[sum + 2u].keys;
+          l2.insert(l2.end(), twos[worker].begin(), twos[worker].end());
+        }
+        if (!fours[worker].empty()) {
+          std::vector<Key>& l4 = m_layers[sum + 4u].keys;
+          l4.insert(l4.end(), fours[worker].begin(), fours[worker].end());
+        }
+      }
+    }
+  }
+
+  void
+  Solver::evaluate(unsigned target) {
+    Layer none;
+
+    for (std::map<unsigned, Layer>::reverse_iterator it = m_layers.rbegin() ; it != m_layers.rend() ; ++it) {
+      Layer& l = it->second;
+      std::size_t count = l.keys.size();
+
+      l.score.resize(count, 0.0f);
+      l.win.resize(count, 0.0f);
+      l.move.resize(count, static_cast<uint8_t>(Direction::Count));
+      l.winMove.resize(count, static_cast<uint8_t>(Direction::Count));
+
+      std::map<unsigned, Layer>::const_iterator i2 = m_layers.find(it->first + 2u);
+      std::map<unsigned, Layer>::const_iterator i4 = m_layers.find(it->first + 4u);
+      const Layer& l2 = (i2 == m_layers.end() ? none : i2->second);
+      const Layer& l4 = (i4 == m_layers.end() ? none : i4->second);
+
+      parallelFor(
+        count,
+        [&](std::size_t begin, std::size_t end, unsigned /*worker*/) {
+          for (std::size_t id = begin ; id < end ; ++id) {
+            PackedBoard b = PackedBoard::fromKey(l.keys[id], m_width, m_height);
+            bool won = (b.maxExponent() >= target);
+
+            float bestScore = 0.0f;
+            float bestWin = (won ? 1.0f : 0.0f);
+
+            for (unsigned d = 0u ; d < static_cast<unsigned>(Direction::Count) ; ++d) {
+              PackedBoard moved = b;
+              unsigned points = 0u;
+              if (!moved.move(static_cast<Direction>(d), points)) {
+                continue;
+              }
+
+              // Average the values over all the possible
+              // spawns of the next tile.
+              float score = 0.0f, win = 0.0f;
+              unsigned empty = 0u;
+
+              for (unsigned y = 0u ; y < m_height ; ++y) {
+                for (unsigned x = 0u ; x < m_width ; ++x) {
+                  if (moved.exponent(x, y) != 0u) {
+                    continue;
+                  }
+
+                  ++empty;
+
+                  PackedBoard s = moved;
+                  s.set(x, y, 1u);
+                  std::size_t s2 = indexOf(l2.keys, s.canonicalKey());
+                  s.set(x, y, 2u);
+                  std::size_t s4 = indexOf(l4.keys, s.canonicalKey());
+
+                  if (s2 < l2.keys.size()) {
+                    score += SPAWN_TWO_PROBABILITY * l2.score[s2];
+                    win += SPAWN_TWO_PROBABILITY * l2.win[s2];
+                  }
+                  if (s4 < l4.keys.size()) {
+                    score += (1.0f - SPAWN_TWO_PROBABILITY) * l4.score[s4];
+                    win += (1.0f - SPAWN_TWO_PROBABILITY) * l4.win[s4];
+                  }
+                }
+              }
+
+              score = points + score / empty;
+              win /= empty;
+
+              if (l.move[id] == static_cast<uint8_t>(Direction::Count) || score > bestScore) {
+                bestScore = score;
+                l.move[id] = static_cast<uint8_t>(d);
+              }
+              if (!won && (l.winMove[id] == static_cast<uint8_t>(Direction::Count) || win > bestWin)) {
+                bestWin = win;
+                l.winMove[id] = static_cast<uint8_t>(d);
+              }
+            }
+
+            // Once the target is reached any move keeps the
+            // win: we follow the best scoring one.
+            if (won) {
+              l.winMove[id] = l.move[id];
+            }
+
+            l.score[id] = bestScore;
+            l.win[id] = bestWin;
+          }
+        }
+      );
+
+      verbose("Evaluated layer " + std::to_string(it->first) + " with " + std::to_string(count) + " position(s)");
+    }
+  }
+
+  void
+  Solver::parallelFor(std::size_t count,
+                      const std::function<void(std::size_t, std::size_t, unsigned)>& process) const
+  {
+    // Small ranges are not worth spawning threads.
+    if (count < 1024u || m_threads == 1u) {
+      process(0u, count, 0u);
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    std::size_t chunk = (count + m_threads - 1u) / m_threads;
+
+    for (unsigned worker = 0u ; worker < m_threads ; ++worker) {
+      std::size_t begin = std::min(count, worker * chunk);
+      std::size_t end = std::min(count, begin + chunk);
+
+      workers.push_back(std::thread(process, begin, end, worker));
+    }
+
+    for (std::thread& t : workers) {
+      t.join();
+    }
+  }
+
+}
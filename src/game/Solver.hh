@@ -0,0 +1,138 @@
+#ifndef    SOLVER_HH
+# define   SOLVER_HH
+
+# include <map>
+# include <vector>
+# include <memory>
+# include <core_utils/CoreObject.hh>
+# include "PackedBoard.hh"
+# include "SolvedTable.hh"
+
+namespace two48 {
+
+  /// @brief - Offline exact solver for small boards. It enumerates
+  /// all the positions reachable from the initial states with a
+  /// breadth first search and then computes the optimal values of
+  /// each position with a retrograde analysis.
+  /// The search relies on the fact that the sum of the tiles grows
+  /// by the value of the spawned tile at each move: positions can
+  /// be grouped in layers sharing the same sum, and each layer only
+  /// depends on the layers with a larger sum. Each layer is then
+  /// processed in parallel.
+  /// Only the canonical representative of each class of symmetric
+  /// positions is stored, which divides the memory needed by up to
+  /// eight on square boards.
+  class Solver: public utils::CoreObject {
+    public:
+
+      /**
+       * @brief - Create a new solver for boards with the specified
+       *          dimensions. Only boards with at most `9` cells can
+       *          be solved.
+       * @param width - the width of the board.
+       * @param height - the height of the board.
+       * @param threads - the number of threads to use. A value of
+       *                  `0` uses the available hardware threads.
+       */
+      Solver(unsigned width,
+             unsigned height,
+             unsigned threads = 0u);
+
+      /**
+       * @brief - Enumerate all the reachable positions and compute
+       *          for each of them the expected score and the win
+       *          probability with an optimal play.
+       * @param target - the value of the tile considered as a win.
+       *                 A value of `0` uses the largest tile that
+       *                 can be reached on this board.
+       */
+      void
+      solve(unsigned target = 0u);
+
+      /**
+       * @brief - The number of positions found by the last call to
+       *          `solve`.
+       * @return - the count of positions.
+       */
+      std::size_t
+      states() const noexcept;
+
+      /**
+       * @brief - Save the result of the solver to the provided file.
+       *          The format can be mapped in memory and queried with
+       *          the `SolvedTable` class.
+       * @param file - the name of the output file.
+       */
+      void
+      save(const std::string& file) const;
+
+    private:
+
+      /// @brief - The positions sharing the same sum of tiles along
+      /// with their values: all vectors are indexed alike and keys
+      /// are sorted.
+      struct Layer {
+        std::vector<Key> keys;
+
+        std::vector<float> score;
+        std::vector<float> win;
+
+        std::vector<uint8_t> move;
+        std::vector<uint8_t> winMove;
+      };
+
+      /**
+       * @brief - Generate the layers of positions reachable from the
+       *          initial states of a game.
+       */
+      void
+      enumerate();
+
+      /**
+       * @brief - Compute the values of all positions starting from
+       *          the layers with the largest sum.
+       * @param target - the exponent of the tile considered a win.
+       */
+      void
+      evaluate(unsigned target);
+
+      /**
+       * @brief - Run the input process over `count` elements split
+       *          in contiguous ranges among the worker threads.
+       * @param count - the number of elements to process.
+       * @param process - the process receiving the range to handle
+       *                  and the index of the worker.
+       */
+      void
+      parallelFor(std::size_t count,
+                  const std::function<void(std::size_t, std::size_t, unsigned)>& process) const;
+
+    private:
+
+      /**
+       * @brief - The dimensions of the boards to solve.
+       */
+      unsigned m_width;
+      unsigned m_height;
+
+      /**
+       * @brief - The number of worker threads.
+       */
+      unsigned m_threads;
+
+      /**
+       * @brief - The value of the tile considered as a win.
+       */
+      unsigned m_target;
+
+      /**
+       * @brief - The positions of the board grouped by the sum of
+       *          their tiles.
+       */
+      std::map<unsigned, Layer> m_layers;
+  };
+
+  using SolverShPtr = std::shared_ptr<Solver>;
+}
+
+#endif    /* SOLVER_HH */
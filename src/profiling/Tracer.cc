@@ -0,0 +1,224 @@
+
+# include "Tracer.hh"
+# include <algorithm>
+# include <atomic>
+# include <chrono>
+# include <cstdio>
+# include <fstream>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+/// @brief - The number of spans kept for each thread: older spans
+/// are overwritten.
+# define SPANS_PER_THREAD 65536u
+
+namespace {
+
+  /// @brief - A recorded span.
+  struct Event {
+    const char* name;
+    const char* category;
+    utils::TimeStamp start;
+    utils::TimeStamp end;
+  };
+
+  /// @brief - The spans recorded by a thread. Only this thread
+  /// writes in the buffer: the number of spans is published once
+  /// a span is written so that it can be dumped from any thread.
+  /// The buffer is flagged while a span is written so that the
+  /// dump can wait for it to complete.
+  struct Buffer {
+    // The identifier of the thread in the trace.
+    unsigned tid;
+
+    // The ring buffer of spans.
+    std::vector<Event> events;
+
+    // The total number of spans written in the buffer.
+    std::atomic<uint64_t> count;
+
+    // Whether the thread is writing a span in the buffer.
+    std::atomic<bool> writing;
+  };
+
+  using BufferShPtr = std::shared_ptr<Buffer>;
+
+  /// @brief - The buffers of all the threads which recorded spans:
+  /// they are kept when the thread exits so that its spans can
+  /// still be dumped. The lock is only needed when a thread records
+  /// its first span and when dumping the spans.
+  struct Registry {
+    std::mutex locker;
+    std::vector<BufferShPtr> buffers;
+
+    // The time at which the recording was last started: older
+    // spans are not dumped.
+    utils::TimeStamp since;
+
+    std::atomic<bool> recording;
+  };
+
+  Registry&
+  registry() noexcept {
+    static Registry r{{}, {}, utils::now(), {false}};
+    return r;
+  }
+
+  BufferShPtr
+  createBuffer() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.locker);
+
+    BufferShPtr b = std::make_shared<Buffer>();
+    b->tid = static_cast<unsigned>(r.buffers.size());
+    b->events.resize(SPANS_PER_THREAD);
+    b->count = 0u;
+    b->writing = false;
+
+    r.buffers.push_back(b);
+
+    return b;
+  }
+
+  Buffer&
+  localBuffer() {
+    // The buffer is allocated when the thread records its
+    // first span.
+    thread_local BufferShPtr buffer = createBuffer();
+    return *buffer;
+  }
+
+}
+
+namespace profiling {
+
+  void
+  Tracer::start() noexcept {
+    Registry& r = registry();
+
+    {
+      std::lock_guard<std::mutex> guard(r.locker);
+      r.since = utils::now();
+    }
+
+    r.recording.store(true, std::memory_order_release);
+  }
+
+  void
+  Tracer::stop() noexcept {
+    // Wait for a dump to complete as it restores the state
+    // of the recording when it is done.
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.locker);
+
+    r.recording.store(false, std::memory_order_release);
+  }
+
+  bool
+  Tracer::recording() noexcept {
+    return registry().recording.load(std::memory_order_relaxed);
+  }
+
+  void
+  Tracer::record(const char* name,
+                 const char* category,
+                 const utils::TimeStamp& start,
+                 const utils::TimeStamp& end) noexcept
+  {
+    if (!recording()) {
+      return;
+    }
+
+    Buffer& b = localBuffer();
+
+    // Flag the buffer before checking the recording again:
+    // either the dump sees the flag and waits for the span
+    // to be written or we see that the recording has been
+    // paused and don't write anything.
+    b.writing.store(true, std::memory_order_seq_cst);
+
+    if (registry().recording.load(std::memory_order_seq_cst)) {
+      uint64_t count = b.count.load(std::memory_order_relaxed);
+      b.events[count % SPANS_PER_THREAD] = Event{name, category, start, end};
+      b.count.store(count + 1u, std::memory_order_release);
+    }
+
+    b.writing.store(false, std::memory_order_release);
+  }
+
+  int
+  Tracer::dump(const std::string& file) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.locker);
+
+    // Pause the recording while reading the buffers: threads
+    // would otherwise overwrite the spans being dumped. We
+    // also wait for the spans being written to complete.
+    bool active = r.recording.exchange(false, std::memory_order_seq_cst);
+    for (unsigned id = 0u ; id < r.buffers.size() ; ++id) {
+      while (r.buffers[id]->writing.load(std::memory_order_seq_cst)) {
+        std::this_thread::yield();
+      }
+    }
+
+    int written = write(file);
+
+    r.recording.store(active, std::memory_order_release);
+
+    return written;
+  }
+
+  int
+  Tracer::write(const std::string& file) {
+    const Registry& r = registry();
+
+    std::ofstream out(file);
+    if (!out.good()) {
+      return -1;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // Timestamps and durations are expressed in microseconds
+    // relatively to the start of the recording: this needs
+    // a double precision for long recordings.
+    int written = 0;
+    char buf[256];
+
+    for (unsigned id = 0u ; id < r.buffers.size() ; ++id) {
+      const Buffer& b = *r.buffers[id];
+
+      uint64_t count = b.count.load(std::memory_order_acquire);
+      uint64_t n = std::min<uint64_t>(count, SPANS_PER_THREAD);
+
+      for (uint64_t s = count - n ; s < count ; ++s) {
+        const Event& e = b.events[s % SPANS_PER_THREAD];
+        if (e.start < r.since) {
+          continue;
+        }
+
+        std::snprintf(
+          buf,
+          sizeof(buf),
+          "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+          (written > 0 ? "," : ""),
+          e.name,
+          e.category,
+          b.tid,
+          std::chrono::duration<double, std::micro>(e.start - r.since).count(),
+          std::chrono::duration<double, std::micro>(e.end - e.start).count()
+        );
+
+        out << buf;
+        ++written;
+      }
+    }
+
+    out << "\n]}\n";
+
+    return (out.good() ? written : -1);
+  }
+
+}
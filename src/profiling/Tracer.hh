@@ -0,0 +1,131 @@
+#ifndef    TRACER_HH
+# define   TRACER_HH
+
+# include <string>
+# include <core_utils/TimeUtils.hh>
+
+namespace profiling {
+
+  /// @brief - Records spans of execution (a name, a category and
+  /// the time interval they cover) so that they can be exported
+  /// in the trace event format understood by trace viewers (e.g.
+  /// `chrome://tracing` or Perfetto).
+  /// Each thread records its spans in its own fixed size buffer
+  /// so that recording does not need any lock nor allocation:
+  /// when a buffer is full the oldest spans are overwritten. No
+  /// span is recorded until the recording is started, in which
+  /// case the cost of a span is a check of an atomic flag.
+  /// The names and categories of the spans are not copied: they
+  /// should be string literals.
+  class Tracer {
+    public:
+
+      /**
+       * @brief - Start recording spans. Spans recorded before this
+       *          call are discarded from the next dumps.
+       */
+      static void
+      start() noexcept;
+
+      /**
+       * @brief - Stop recording spans. The spans recorded so far
+       *          are kept until the next call to `start`.
+       */
+      static void
+      stop() noexcept;
+
+      /**
+       * @brief - Whether spans are currently recorded.
+       * @return - `true` if the recording is active.
+       */
+      static bool
+      recording() noexcept;
+
+      /**
+       * @brief - Record a span on the buffer of the calling thread.
+       *          Nothing happens if the recording is not active.
+       * @param name - the name of the span.
+       * @param category - the category of the span.
+       * @param start - the beginning of the span.
+       * @param end - the end of the span.
+       */
+      static void
+      record(const char* name,
+             const char* category,
+             const utils::TimeStamp& start,
+             const utils::TimeStamp& end) noexcept;
+
+      /**
+       * @brief - Write the spans recorded since the last start of
+       *          the recording by all threads to the output file,
+       *          in the JSON trace event format. The recording
+       *          is paused while the spans are written.
+       * @param file - the path of the output file.
+       * @return - the number of spans written or a negative value
+       *           if the file could not be written.
+       */
+      static int
+      dump(const std::string& file);
+
+    private:
+
+      /**
+       * @brief - Write the spans to the output file. The recording
+       *          should be paused and the registry locked.
+       * @param file - the path of the output file.
+       * @return - the number of spans written or a negative value
+       *           if the file could not be written.
+       */
+      static int
+      write(const std::string& file);
+  };
+
+  /// @brief - Records the time spent between its creation and its
+  /// destruction as a span, if the recording is active when it is
+  /// created.
+  class Span {
+    public:
+
+      /**
+       * @brief - Start a new span.
+       * @param name - the name of the span, should be a literal.
+       * @param category - the category of the span, should be a
+       *                   literal.
+       */
+      Span(const char* name, const char* category) noexcept;
+
+      /**
+       * @brief - Record the span.
+       */
+      ~Span();
+
+      Span(const Span&) = delete;
+
+      Span&
+      operator=(const Span&) = delete;
+
+    private:
+
+      /**
+       * @brief - The name and category of the span.
+       */
+      const char* m_name;
+      const char* m_category;
+
+      /**
+       * @brief - Whether the recording was active when the span
+       *          was created.
+       */
+      bool m_active;
+
+      /**
+       * @brief - The beginning of the span.
+       */
+      utils::TimeStamp m_start;
+  };
+
+}
+
+# include "Tracer.hxx"
+
+#endif    /* TRACER_HH */
@@ -0,0 +1,30 @@
+#ifndef    TRACER_HXX
+# define   TRACER_HXX
+
+# include "Tracer.hh"
+
+namespace profiling {
+
+  inline
+  Span::Span(const char* name, const char* category) noexcept:
+    m_name(name),
+    m_category(category),
+
+    m_active(Tracer::recording()),
+    m_start()
+  {
+    if (m_active) {
+      m_start = utils::now();
+    }
+  }
+
+  inline
+  Span::~Span() {
+    if (m_active) {
+      Tracer::record(m_name, m_category, m_start, utils::now());
+    }
+  }
+
+}
+
+#endif    /* TRACER_HXX */
@@ -24,6 +24,9 @@ namespace pge {
     }),
 
     m_pos(pos),
+    m_absPos(),
+    m_boundsMin(),
+    m_boundsMax(),
     m_size(size),
 
     m_bg(bg),
@@ -35,15 +38,35 @@ namespace pge {
     m_parent(parent),
     m_children(),
 
-    m_callback()
+    m_callback(),
+
+    m_dirty(true),
+
+    m_hover(Hover{
+      false,          // valid
+      olc::vi2d(),    // mouse
+      {false, false}, // result
+      true            // active
+    }),
+
+    m_revision(1u),
+    m_textSize(),
+    m_textRevision(0u)
   {
     setService("menu");
 
     loadFGTile();
+    updatePosition();
   }
 
   void
   Menu::render(olc::PixelGameEngine* pge) const {
+    renderBackground(pge);
+    renderContent(pge);
+  }
+
+  void
+  Menu::renderBackground(olc::PixelGameEngine* pge) const {
     // If the menu is not visible, do nothing.
     if (!m_state.visible) {
       return;
@@ -57,14 +80,24 @@ namespace pge {
     }
     pge->FillRectDecal(pos, m_size, c);
 
-    // Render this menu.
-    renderSelf(pge);
-
     // And then draw children in the order there were
     // added: it means that the last added menu will
     // be repainted on top of the others.
     for (unsigned id = 0u ; id < m_children.size() ; ++id) {
-      m_children[id]->render(pge);
+      m_children[id]->renderBackground(pge);
+    }
+  }
+
+  void
+  Menu::renderContent(olc::PixelGameEngine* pge) const {
+    if (!m_state.visible) {
+      return;
+    }
+
+    renderSelf(pge);
+
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      m_children[id]->renderContent(pge);
     }
   }
 
@@ -79,15 +112,56 @@ namespace pge {
       return res;
     }
 
+    // In case the mouse did not move and nothing changed
+    // since the last call the state of the menus would
+    // stay the same. Clicks are always processed as they
+    // trigger actions.
+    bool click = (c.buttons[controls::mouse::Left] == controls::ButtonState::Released);
+    olc::vi2d mouse(c.mPosX, c.mPosY);
+
+    if (!click && m_hover.valid && m_hover.mouse == mouse) {
+      return m_hover.result;
+    }
+
     // Make sure that the children get their chance
-    // to process the event.
+    // to process the event. Children which are not
+    // under the mouse and neither highlighted nor
+    // selected would not change: we skip them.
     for (unsigned id = 0u ; id < m_children.size() ; ++id) {
-      menu::InputHandle rc = m_children[id]->processUserInput(c, actions);
+      const MenuShPtr& child = m_children[id];
+      if (!child->m_hover.active && !child->contains(mouse)) {
+        continue;
+      }
+
+      menu::InputHandle rc = child->processUserInput(c, actions);
 
       res.relevant = res.relevant || rc.relevant;
       res.selected = res.selected || rc.selected;
     }
 
+    processSelf(c, click, res, actions);
+
+    // Save the result: it can't be reused after a click
+    // as the next frame will not have any.
+    m_hover.valid = !click;
+    m_hover.mouse = mouse;
+    m_hover.result = res;
+
+    m_hover.active = m_state.highlighted || m_state.selected;
+    for (unsigned id = 0u ; id < m_children.size() && !m_hover.active ; ++id) {
+      const Menu& child = *m_children[id];
+      m_hover.active = child.m_state.visible && child.m_hover.active;
+    }
+
+    return res;
+  }
+
+  void
+  Menu::processSelf(const controls::State& c,
+                    bool click,
+                    menu::InputHandle& res,
+                    std::vector<ActionShPtr>& actions)
+  {
     // If the mouse is not inside this element, stop
     // the process here: children still got a chance
     // to update their state with this event. And no
@@ -96,27 +170,24 @@ namespace pge {
     // following conditions apply: it either mean
     // that the mouse is not inside this menu or
     // that a child is more relevant than we are.
-    bool click = (c.buttons[controls::mouse::Left] == controls::ButtonState::Released);
-
-    olc::vi2d ap = absolutePosition();
-    if (c.mPosX < ap.x || c.mPosX >= ap.x + m_size.x ||
-        c.mPosY < ap.y || c.mPosY >= ap.y + m_size.y ||
+    if (c.mPosX < m_absPos.x || c.mPosX >= m_absPos.x + m_size.x ||
+        c.mPosY < m_absPos.y || c.mPosY >= m_absPos.y + m_size.y ||
         res.relevant || res.selected)
     {
-      m_state.highlighted = false;
+      setHighlighted(false);
 
       if (res.selected || click) {
-        m_state.selected = false;
+        setSelected(false);
       }
 
-      return res;
+      return;
     }
 
     // This menu is now highlighted. We also set
     // the return value to indicate that this
     // event was indeed relevant.
     bool process = onHighlight();
-    m_state.highlighted = process;
+    setHighlighted(process);
     res.relevant = true;
 
     // In case the user clicks on the menu, we need
@@ -130,11 +201,9 @@ namespace pge {
 
       // But always register the internal state as
       // selected.
-      m_state.selected = true;
+      setSelected(true);
       res.selected = true;
     }
-
-    return res;
   }
 
   void
@@ -158,12 +227,30 @@ namespace pge {
     child->m_parent = this;
 
     m_children.push_back(child);
+    makeDirty();
 
     // Update properties of each child in response
     // to the new child.
     updateChildren();
   }
 
+  bool
+  Menu::consumeChanges() noexcept {
+    bool dirty = m_dirty;
+    m_dirty = false;
+
+    // As a change is propagated to all the ancestors of
+    // a menu, children can only be dirty if this menu is
+    // dirty as well.
+    if (dirty) {
+      for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+        m_children[id]->consumeChanges();
+      }
+    }
+
+    return dirty;
+  }
+
   void
   Menu::setAction(menu::RegisterAction action) {
     m_callback = action;
@@ -187,14 +274,15 @@ namespace pge {
     // in the menu will change.
     // Also, in case there's no text nor sprite to
     // display we can return right now.
-    if (m_fg.text == "" && m_fgSprite == nullptr) {
+    olc::Decal* icon = (m_fgSprite != nullptr ? m_fgSprite->decal() : nullptr);
+    if (m_fg.text == "" && icon == nullptr) {
       return;
     }
 
     olc::vi2d ap = absolutePosition();
 
-    if (m_fg.text != "" && m_fgSprite == nullptr) {
-      olc::vi2d ts = pge->GetTextSize(m_fg.text);
+    if (m_fg.text != "" && icon == nullptr) {
+      olc::vi2d ts = textSize(pge);
 
       olc::vi2d p;
 
@@ -230,7 +318,7 @@ namespace pge {
       return;
     }
 
-    if (m_fg.text == "" && m_fgSprite != nullptr) {
+    if (m_fg.text == "" && icon != nullptr) {
       // Center the image if it is the only element
       // to display.
       olc::vi2d p(
@@ -238,23 +326,23 @@ namespace pge {
         static_cast<int>(ap.y + m_size.y / 2.0f - m_fg.size.y / 2.0f)
       );
 
-      olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
+      olc::vi2d ss(icon->sprite->width, icon->sprite->height);
       olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
 
-      pge->DrawPartialDecal(p, m_fgSprite, olc::vi2d(), ss, s);
+      pge->DrawPartialDecal(p, icon, olc::vi2d(), ss, s);
 
       return;
     }
 
     // Both text and icon should be displayed: the
     // order is specified in the content description.
-    olc::vi2d ts = pge->GetTextSize(m_fg.text);
+    olc::vi2d ts = textSize(pge);
     olc::vi2d cs = ts + m_fg.size;
 
     olc::vi2d tp;
     olc::vi2d sp;
 
-    olc::vi2d ss(m_fgSprite->sprite->width, m_fgSprite->sprite->height);
+    olc::vi2d ss(icon->sprite->width, icon->sprite->height);
     olc::vf2d s(1.0f * m_fg.size.x / ss.x, 1.0f * m_fg.size.y / ss.y);
 
     switch (m_fg.order) {
@@ -345,7 +433,17 @@ namespace pge {
 
     pge->DrawStringDecal(tp, m_fg.text, c);
 
-    pge->DrawPartialDecal(sp, m_fgSprite, olc::vi2d(), ss, s);
+    pge->DrawPartialDecal(sp, icon, olc::vi2d(), ss, s);
+  }
+
+  olc::vi2d
+  Menu::textSize(olc::PixelGameEngine* pge) const {
+    if (m_textRevision != m_revision) {
+      m_textSize = pge->GetTextSize(m_fg.text);
+      m_textRevision = m_revision;
+    }
+
+    return m_textSize;
   }
 
   void
@@ -359,9 +457,8 @@ namespace pge {
     m_fg.size.x = std::max(m_fg.size.x, 10);
     m_fg.size.y = std::max(m_fg.size.y, 10);
 
-    // Load the sprite.
-    olc::Sprite* spr = new olc::Sprite(m_fg.icon);
-    m_fgSprite = new olc::Decal(spr);
+    // Menus using the same icon share the same image.
+    m_fgSprite = ImageCache::instance().load(m_fg.icon);
   }
 
   void
@@ -490,6 +587,48 @@ namespace pge {
           break;
       }
     }
+
+    updateLayout();
+  }
+
+  void
+  Menu::updateLayout() noexcept {
+    updatePosition();
+
+    // The bounds of the ancestors might change as well.
+    for (Menu* m = m_parent ; m != nullptr ; m = m->m_parent) {
+      m->updateBounds();
+    }
+  }
+
+  void
+  Menu::updatePosition() noexcept {
+    m_absPos = (m_parent != nullptr ? m_parent->m_absPos : olc::vi2d(0, 0));
+    m_absPos += m_pos;
+
+    // The menu might have moved under the mouse.
+    m_hover.valid = false;
+
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      m_children[id]->updatePosition();
+    }
+
+    updateBounds();
+  }
+
+  void
+  Menu::updateBounds() noexcept {
+    m_boundsMin = m_absPos;
+    m_boundsMax = m_absPos + m_size;
+
+    for (unsigned id = 0u ; id < m_children.size() ; ++id) {
+      const Menu& child = *m_children[id];
+
+      m_boundsMin.x = std::min(m_boundsMin.x, child.m_boundsMin.x);
+      m_boundsMin.y = std::min(m_boundsMin.y, child.m_boundsMin.y);
+      m_boundsMax.x = std::max(m_boundsMax.x, child.m_boundsMax.x);
+      m_boundsMax.y = std::max(m_boundsMax.y, child.m_boundsMax.y);
+    }
   }
 
 }
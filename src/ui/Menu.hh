@@ -5,6 +5,7 @@
 # include <vector>
 # include <core_utils/CoreObject.hh>
 # include "olcEngine.hh"
+# include "ImageCache.hh"
 # include "BackgroundDesc.hh"
 # include "MenuContentDesc.hh"
 # include "Controls.hh"
@@ -146,15 +147,57 @@ namespace pge {
        *         and hide the internal complexity of the menu.
        *         Note: we draw on the active layer so it has
        *         to be configured before calling this method.
+       *         The backgrounds of the menu and its children are
+       *         drawn first and then their content: consecutive
+       *         decals sharing a texture are batched by the
+       *         renderer so this produces a single draw for all
+       *         the backgrounds. This assumes that children don't
+       *         overlap the content of their parent.
        * @param pge - the rendering engine to display the menu.
        */
       void
       render(olc::PixelGameEngine* pge) const;
 
+      /**
+       * @brief - Render the background of this menu and of its
+       *          children. Along with `renderContent` this allows
+       *          to draw the backgrounds of several menus before
+       *          their content.
+       * @param pge - the rendering engine to display the menu.
+       */
+      void
+      renderBackground(olc::PixelGameEngine* pge) const;
+
+      /**
+       * @brief - Render the content (text and icon) of this menu
+       *          and of its children.
+       * @param pge - the rendering engine to display the menu.
+       */
+      void
+      renderContent(olc::PixelGameEngine* pge) const;
+
+      /**
+       * @brief - Whether the visual representation of this menu
+       *          or any of its children changed since the last
+       *          call to this method. The changes are reset so
+       *          that the next call returns `false` until a new
+       *          change happens.
+       *          This allows to only render the menus again when
+       *          something changed.
+       * @return - `true` if the menu should be rendered again.
+       */
+      bool
+      consumeChanges() noexcept;
+
       /**
        * @brief - Used to process the user input defined in
        *          the argument and update the internal state
        *          of this menu if needed.
+       *          Children are only visited when the mouse is in
+       *          their bounds or when their state needs to be
+       *          reset, and the resolution is skipped entirely
+       *          when the mouse did not move and no click was
+       *          made since the last call.
        * @param c - the controls and user input for this
        *            frame.
        * @param actions - the list of actions produced by the
@@ -270,7 +313,8 @@ namespace pge {
       /**
        * @brief - Used to obtain the absolute position of the
        *          menu within the app, considering the position
-       *          of the parent (if defined).
+       *          of the parent (if defined). The position is
+       *          computed when the layout changes.
        * @return - the absolute position of this menu.
        */
       olc::vi2d
@@ -323,6 +367,86 @@ namespace pge {
       void
       updateChildren();
 
+      /**
+       * @brief - Update the absolute position and the bounds of
+       *          this menu and its children, along with the bounds
+       *          of its ancestors. Called whenever the layout of
+       *          the menu changes.
+       */
+      void
+      updateLayout() noexcept;
+
+      /**
+       * @brief - Update the absolute position of this menu and of
+       *          its children from the position of the parent.
+       */
+      void
+      updatePosition() noexcept;
+
+      /**
+       * @brief - Compute the bounds of this menu from its area and
+       *          the bounds of its children.
+       */
+      void
+      updateBounds() noexcept;
+
+      /**
+       * @brief - Whether the input position is within the bounds of
+       *          this menu or of any of its children.
+       * @param p - the position to check.
+       * @return - `true` if the position is inside the bounds.
+       */
+      bool
+      contains(const olc::vi2d& p) const noexcept;
+
+      /**
+       * @brief - Returns the size of the text of the menu. It is
+       *          only measured again when the content changes.
+       * @param pge - the engine used to measure the text.
+       * @return - the size of the text in pixels.
+       */
+      olc::vi2d
+      textSize(olc::PixelGameEngine* pge) const;
+
+      /**
+       * @brief - Mark this menu and all its ancestors as changed so
+       *          that they are rendered again. The last resolution
+       *          of the user input is also discarded.
+       */
+      void
+      makeDirty() noexcept;
+
+      /**
+       * @brief - Update the highlighted status of the menu and mark
+       *          it as changed if needed.
+       * @param highlighted - `true` if the menu is highlighted.
+       */
+      void
+      setHighlighted(bool highlighted) noexcept;
+
+      /**
+       * @brief - Update the selected status of the menu and mark it
+       *          as changed if needed.
+       * @param selected - `true` if the menu is selected.
+       */
+      void
+      setSelected(bool selected) noexcept;
+
+      /**
+       * @brief - Update the state of this menu itself once the
+       *          children processed the user input.
+       * @param c - the controls and user input for this frame.
+       * @param click - whether the user clicked in this frame.
+       * @param res - the result of the processing of the children
+       *              updated with the result for this menu.
+       * @param actions - the list of actions produced by the menu.
+       */
+      void
+      processSelf(const controls::State& c,
+                  bool click,
+                  menu::InputHandle& res,
+                  std::vector<ActionShPtr>& actions);
+
     private:
 
       /**
@@ -352,6 +476,28 @@ namespace pge {
         bool selected;
       };
 
+      /**
+       * @brief - Convenience structure describing the last user
+       *          input processed by the menu.
+       */
+      struct Hover {
+        // Whether the result can be reused: this is the case
+        // until the menu or one of its children changes.
+        bool valid;
+
+        // The position of the mouse for the last resolution.
+        olc::vi2d mouse;
+
+        // The result of the last resolution.
+        menu::InputHandle result;
+
+        // Whether this menu or any of its visible children is
+        // highlighted or selected. When this is not the case
+        // and the mouse is not in the menu there's no need to
+        // process it.
+        bool active;
+      };
+
       /**
        * @brief - Describe the current state for this menu. It is
        *          used as a way to regroup all information needed
@@ -365,6 +511,20 @@ namespace pge {
        */
       olc::vf2d m_pos;
 
+      /**
+       * @brief - The absolute position of the menu, cached so that
+       *          it is not computed from the parent at each frame.
+       */
+      olc::vi2d m_absPos;
+
+      /**
+       * @brief - The smallest area containing this menu and all its
+       *          children in absolute coordinates. Children are not
+       *          clipped so they might extend beyond this menu.
+       */
+      olc::vi2d m_boundsMin;
+      olc::vi2d m_boundsMax;
+
       /**
        * @brief - The size of the menu in pixels.
        */
@@ -385,9 +545,10 @@ namespace pge {
       /**
        * @brief - Hold the sprite used as an icon for this menu. It
        *          might be `null` in case none is used in the menu's
-       *          content.
+       *          content. The image is shared with all the elements
+       *          using the same icon.
        */
-      olc::Decal* m_fgSprite;
+      ImageShPtr m_fgSprite;
 
       /**
        * @brief - The layout for this menu. Allow to define how the
@@ -413,6 +574,32 @@ namespace pge {
        *          clicked upon.
        */
       menu::RegisterAction m_callback;
+
+      /**
+       * @brief - Whether the visual representation of this menu or
+       *          of one of its children changed since it was last
+       *          consumed.
+       */
+      bool m_dirty;
+
+      /**
+       * @brief - The last user input processed by this menu.
+       */
+      Hover m_hover;
+
+      /**
+       * @brief - Incremented each time the content of the menu
+       *          changes. Setting the same content again does not
+       *          change the revision.
+       */
+      unsigned m_revision;
+
+      /**
+       * @brief - The size of the text of the menu and the revision
+       *          of the content for which it was measured.
+       */
+      mutable olc::vi2d m_textSize;
+      mutable unsigned m_textRevision;
   };
 
 }
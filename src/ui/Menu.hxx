@@ -20,25 +20,45 @@ namespace pge {
   inline
   void
   Menu::setVisible(bool visible) noexcept {
+    if (m_state.visible == visible) {
+      return;
+    }
+
     m_state.visible = visible;
+    makeDirty();
   }
 
   inline
   void
   Menu::setClickable(bool click) noexcept {
+    if (m_state.clickable == click) {
+      return;
+    }
+
     m_state.clickable = click;
+    makeDirty();
   }
 
   inline
   void
   Menu::setSelectable(bool select) noexcept {
+    if (m_state.selectable == select) {
+      return;
+    }
+
     m_state.selectable = select;
+    makeDirty();
   }
 
   inline
   void
   Menu::setEnabled(bool enabled) noexcept {
+    if (m_state.enabled == enabled) {
+      return;
+    }
+
     m_state.enabled = enabled;
+    makeDirty();
   }
 
   inline
@@ -63,6 +83,7 @@ namespace pge {
   void
   Menu::setBackground(const menu::BackgroundDesc& bg) {
     m_bg = bg;
+    makeDirty();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -76,6 +97,8 @@ namespace pge {
     clearContent();
     m_fg = mcd;
     loadFGTile();
+    ++m_revision;
+    makeDirty();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -86,7 +109,14 @@ namespace pge {
   inline
   void
   Menu::setText(const std::string& text) {
+    // Nothing to do if the text did not change.
+    if (m_fg.text == text) {
+      return;
+    }
+
     m_fg.text = text;
+    ++m_revision;
+    makeDirty();
 
     // Update the parent's display if possible.
     if (m_parent != nullptr) {
@@ -112,15 +142,7 @@ namespace pge {
   inline
   olc::vi2d
   Menu::absolutePosition() const noexcept {
-    olc::vi2d p(0, 0);
-
-    if (m_parent != nullptr) {
-      p = m_parent->absolutePosition();
-    }
-
-    p += m_pos;
-
-    return p;
+    return m_absPos;
   }
 
   inline
@@ -137,16 +159,54 @@ namespace pge {
 
   inline
   void
-  Menu::clear() {}
+  Menu::makeDirty() noexcept {
+    m_dirty = true;
+
+    // The change might affect which menu is under the mouse.
+    m_hover.valid = false;
+    m_hover.active = true;
+
+    if (m_parent != nullptr) {
+      m_parent->makeDirty();
+    }
+  }
 
   inline
   void
-  Menu::clearContent() {
-    if (m_fgSprite != nullptr) {
-      delete m_fgSprite;
+  Menu::setHighlighted(bool highlighted) noexcept {
+    if (m_state.highlighted != highlighted) {
+      m_state.highlighted = highlighted;
+      makeDirty();
+    }
+  }
+
+  inline
+  void
+  Menu::setSelected(bool selected) noexcept {
+    if (m_state.selected != selected) {
+      m_state.selected = selected;
+      makeDirty();
     }
+  }
 
-    m_fgSprite = nullptr;
+  inline
+  bool
+  Menu::contains(const olc::vi2d& p) const noexcept {
+    return
+      p.x >= m_boundsMin.x && p.x < m_boundsMax.x &&
+      p.y >= m_boundsMin.y && p.y < m_boundsMax.y;
+  }
+
+  inline
+  void
+  Menu::clear() {}
+
+  inline
+  void
+  Menu::clearContent() {
+    // The image is owned by the cache: it will be released
+    // when the cache is cleared.
+    m_fgSprite.reset();
   }
 
 }